@@ -0,0 +1,231 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <stdexcept>
+#include <algorithm>
+
+#include "custom/utils.h"
+#include "custom/game_logic.h"
+#include "custom/player.h"
+
+// console tool that plays robot against robot games without a window
+// (every pairing of difficulties plays the same nr of games, games are spread over all cores,
+// prints win / draw / loss rates of the first player, games per second and move latencies)
+// usage: arena [games per pairing] [rows] [columns] [win line] [time budget ms] [mcts playouts]
+
+struct arena_settings {
+    int nr_games;
+    int nr_rows;
+    int nr_columns;
+    int nr_win_line;
+    int time_budget; // time in ms of HARD robots (iterative deepening)
+    int mcts_playouts;
+};
+
+struct arena_pairing {
+    robot_difficulty first; // plays X (moves first)
+    robot_difficulty second; // plays 0
+};
+
+const arena_pairing pairings[] = {
+    {EASY, EASY}, {EASY, HARD}, {EASY, MCTS},
+    {HARD, EASY}, {HARD, HARD}, {HARD, MCTS},
+    {MCTS, EASY}, {MCTS, HARD}, {MCTS, MCTS}
+};
+const int NR_PAIRINGS = sizeof(pairings) / sizeof(pairings[0]);
+
+// results of the games of one pairing (filled by every worker)
+struct pairing_results {
+    int nr_wins; // games won by the first player
+    int nr_draws;
+    int nr_losses;
+    long long nr_moves;
+};
+
+// a worker adds its results at the end, so workers never wait for each other during games
+struct arena_results {
+    std::mutex results_mutex;
+    pairing_results pairing[NR_PAIRINGS];
+    std::vector<double> move_ms[3]; // latencies of every move, index: EASY, HARD, MCTS
+};
+
+const char* difficulty_name(robot_difficulty diff) {
+    switch (diff) {
+        case EASY: return "EASY";
+        case HARD: return "HARD";
+        case MCTS: return "MCTS";
+        default: return "?";
+    }
+}
+
+int difficulty_slot(robot_difficulty diff) {
+    return diff == EASY ? 0 : (diff == HARD ? 1 : 2);
+}
+
+// robots of a game run on the calling thread, so a game is searched on a single thread
+void set_robot_modifiers(GameModifiers& modifiers, const arena_settings& settings, unsigned int seed) {
+    modifiers.robot_time_budget = settings.time_budget;
+    modifiers.mcts_playouts = settings.mcts_playouts;
+    modifiers.robot_threads = 1;
+    modifiers.tt_size_mb = 4;
+    modifiers.mcts_pool_nodes = 1 << 16;
+    modifiers.robot_seed = seed;
+}
+
+// plays one game, returns index of the winner in symbols order (-1 for a draw)
+int play_game(const arena_settings& settings, const arena_pairing& pairing, int game_index,
+    pairing_results& results, std::vector<double>* move_ms) {
+
+    GameLogic logic(settings.nr_rows, settings.nr_columns, settings.nr_win_line);
+    std::vector<cell_state> symbols_order = {CELL_X, CELL_0};
+    robot_difficulty diffs[2] = {pairing.first, pairing.second};
+
+    // every robot has its own modifiers so the seeds of a game differ (and games can be replayed)
+    GameModifiers modifiers[2];
+    std::vector<Robot*> robots;
+    for (int i = 0; i < 2; i++) {
+        set_robot_modifiers(modifiers[i], settings, game_index * 2 + i + 1);
+        robots.push_back(new Robot(symbols_order[i], &logic, nullptr, diffs[i], symbols_order, modifiers[i]));
+    }
+
+    int winner = -1;
+    int cur_player = 0;
+    while (logic.get_nr_used_cells() < settings.nr_rows * settings.nr_columns) {
+        cell_pos pos;
+
+        auto start = std::chrono::steady_clock::now();
+        bool found = robots[cur_player]->compute_action(pos);
+        auto stop = std::chrono::steady_clock::now();
+        if (found == false) {
+            break;
+        }
+
+        move_ms[difficulty_slot(diffs[cur_player])].push_back(
+            std::chrono::duration<double, std::milli>(stop - start).count());
+        results.nr_moves++;
+
+        logic.set_cell_state(pos, symbols_order[cur_player]);
+        if (logic.check_win() == true) {
+            winner = cur_player;
+            break;
+        }
+        cur_player = 1 - cur_player;
+    }
+
+    for (Robot* robot : robots) {
+        delete robot;
+    }
+    return winner;
+}
+
+// games are numbered pairing by pairing, workers take the next free one
+void arena_worker(const arena_settings& settings, std::atomic<int>& next_game, arena_results& shared) {
+    pairing_results results[NR_PAIRINGS] = {};
+    std::vector<double> move_ms[3];
+    int nr_total_games = settings.nr_games * NR_PAIRINGS;
+
+    for (int game = next_game++; game < nr_total_games; game = next_game++) {
+        int index = game / settings.nr_games;
+        int winner = play_game(settings, pairings[index], game, results[index], move_ms);
+
+        if (winner == 0) {
+            results[index].nr_wins++;
+        } else if (winner == 1) {
+            results[index].nr_losses++;
+        } else {
+            results[index].nr_draws++;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(shared.results_mutex);
+    for (int i = 0; i < NR_PAIRINGS; i++) {
+        shared.pairing[i].nr_wins += results[i].nr_wins;
+        shared.pairing[i].nr_draws += results[i].nr_draws;
+        shared.pairing[i].nr_losses += results[i].nr_losses;
+        shared.pairing[i].nr_moves += results[i].nr_moves;
+    }
+    for (int i = 0; i < 3; i++) {
+        shared.move_ms[i].insert(shared.move_ms[i].end(), move_ms[i].begin(), move_ms[i].end());
+    }
+}
+
+// value below which lies the given fraction of the (sorted) latencies
+double percentile(const std::vector<double>& sorted, double fraction) {
+    int index = std::min((int)sorted.size() - 1, (int)(fraction * sorted.size()));
+    return sorted[index];
+}
+
+int main(int argc, char* argv[]) {
+    arena_settings settings = {100, 3, 3, 3, 50, 2000};
+    int* fields[] = {&settings.nr_games, &settings.nr_rows, &settings.nr_columns, &settings.nr_win_line,
+        &settings.time_budget, &settings.mcts_playouts};
+
+    // every setting is a positive integer (a bad one prints the usage instead of throwing from std::stoi)
+    bool valid = true;
+    for (int i = 1; i < argc && i <= 6 && valid == true; i++) {
+        try {
+            size_t nr_parsed = 0;
+            *fields[i - 1] = std::stoi(argv[i], &nr_parsed);
+            valid = argv[i][nr_parsed] == '\0' && *fields[i - 1] > 0;
+        } catch (const std::exception&) {
+            valid = false; // not a number or out of int range
+        }
+    }
+    if (valid == false || settings.nr_win_line > std::min(settings.nr_rows, settings.nr_columns)) {
+        std::cerr << "usage: arena [games per pairing] [rows] [columns] [win line] [time budget ms] [mcts playouts]\n";
+        std::cerr << "(every setting is a positive integer, win line is at most rows and columns)\n";
+        return 1;
+    }
+
+    arena_results shared;
+    for (int i = 0; i < NR_PAIRINGS; i++) {
+        shared.pairing[i] = {0, 0, 0, 0};
+    }
+    std::atomic<int> next_game(0);
+    int nr_workers = std::max(1, (int)std::thread::hardware_concurrency());
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int i = 0; i < nr_workers; i++) {
+        workers.push_back(std::thread(arena_worker, std::cref(settings), std::ref(next_game), std::ref(shared)));
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    double total_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << settings.nr_rows << "x" << settings.nr_columns << " k=" << settings.nr_win_line << ", "
+        << settings.nr_games << " games per pairing, " << nr_workers << " workers\n";
+    std::cout << std::fixed << std::setprecision(1);
+    for (int i = 0; i < NR_PAIRINGS; i++) {
+        const pairing_results& results = shared.pairing[i];
+        std::cout << "  " << difficulty_name(pairings[i].first) << " vs " << difficulty_name(pairings[i].second)
+            << "  win: " << 100.0 * results.nr_wins / settings.nr_games << "%"
+            << " draw: " << 100.0 * results.nr_draws / settings.nr_games << "%"
+            << " loss: " << 100.0 * results.nr_losses / settings.nr_games << "%"
+            << " moves/game: " << 1.0 * results.nr_moves / settings.nr_games << "\n";
+    }
+
+    std::cout << "games/s: " << settings.nr_games * NR_PAIRINGS / total_s
+        << " (" << total_s << " s)\n";
+    std::cout << std::setprecision(3);
+    for (robot_difficulty diff : {EASY, HARD, MCTS}) {
+        std::vector<double>& latencies = shared.move_ms[difficulty_slot(diff)];
+        if (latencies.empty()) {
+            continue;
+        }
+        std::sort(latencies.begin(), latencies.end());
+        std::cout << "  " << difficulty_name(diff) << " move ms"
+            << "  p50: " << percentile(latencies, 0.5)
+            << " p90: " << percentile(latencies, 0.9)
+            << " p99: " << percentile(latencies, 0.99)
+            << " max: " << latencies.back() << "\n";
+    }
+
+    return 0;
+}
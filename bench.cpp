@@ -0,0 +1,429 @@
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <random>
+#include <algorithm>
+
+#include "custom/logger.h"
+#include "custom/utils.h"
+#include "custom/rasterizer.h"
+#include "custom/game_logic.h"
+#include "custom/game_interface.h"
+#include "custom/player.h"
+
+// console tool that times the hot paths of the engine and of the rendering helpers
+// on boards from 3x3 to 19x19, results are printed as CSV (default) or JSON so they can be
+// compared between commits (rendering helpers are also compared pixel by pixel with the
+// reference versions they replaced, the exit code is 1 if a comparison is out of tolerance)
+// usage: bench [csv|json]
+
+const int BOARD_SIZES[] = {3, 5, 7, 9, 11, 15, 19};
+const int SURFACE_SIZE = 800; // side of the software rendered surface in pixels
+const int SYMBOL_THICKNESS = 4; // thickness the grid uses for symbols (double of the grid lines)
+const int LINE_THICKNESS = 2;
+const double MIN_BENCH_MS = 100; // every benchmark runs at least this long
+const int MINIMAX_EMPTY_CELLS = 7; // plain minimax positions are nearly full
+// strokes are intentionally thicker on diagonals than the reference (which was thinner there),
+// they must still draw this fraction of the reference pixels (the 0 ring must be identical)
+const double MIN_STROKE_COVERAGE = 0.9;
+
+struct bench_result {
+    std::string name;
+    std::string board;
+    long long iterations;
+    double ns_per_op;
+    int draw_calls; // SDL draw calls of one call (rendering only, -1 if not counted)
+    long long pixel_diff; // pixels that differ from the reference helper (-1 if not compared)
+    double coverage; // fraction of the reference pixels also drawn (-1 if not compared)
+    std::string note; // what the comparison must satisfy
+    bool pixels_ok; // comparison is within tolerance (true if not compared)
+};
+
+struct pixel_comparison {
+    long long nr_different;
+    long long nr_reference; // pixels drawn by the reference
+    long long nr_covered; // pixels drawn by both
+};
+
+volatile long long bench_sink; // results of timed calls are written here so they are not optimized out
+
+// runs op in growing batches until MIN_BENCH_MS has passed, returns ns per call
+template <typename Operation>
+double time_operation(Operation op, long long& iterations) {
+    long long batch = 1;
+    double elapsed_ms = 0;
+    iterations = 0;
+
+    while (elapsed_ms < MIN_BENCH_MS) {
+        auto start = std::chrono::steady_clock::now();
+        for (long long i = 0; i < batch; i++) {
+            op(iterations + i);
+        }
+        elapsed_ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        iterations += batch;
+        batch *= 2;
+    }
+
+    return elapsed_ms * 1e6 / iterations;
+}
+
+template <typename Operation>
+void run_bench(std::vector<bench_result>& results, const std::string& name, const std::string& board,
+    Operation op) {
+
+    bench_result result;
+    result.name = name;
+    result.board = board;
+    result.ns_per_op = time_operation(op, result.iterations);
+    result.draw_calls = -1;
+    result.pixel_diff = -1;
+    result.coverage = -1;
+    result.pixels_ok = true;
+    results.push_back(result);
+}
+
+// random position with nr_empty random cells left empty and no finished line (a cell where both
+// symbols would finish a line also stays empty), returns symbol of the player to move
+cell_state fill_position(GameLogic& logic, std::mt19937& rng, int nr_empty) {
+    int nr_rows = logic.get_nr_rows();
+    int nr_columns = logic.get_nr_columns();
+    std::vector<cell_pos> cells = logic.get_available_cells();
+    std::shuffle(cells.begin(), cells.end(), rng);
+
+    for (int i = nr_empty; i < (int)cells.size(); i++) {
+        cell_pos pos = cells[i];
+        cell_state symbol = logic.get_nr_used_cells() % 2 == 0 ? CELL_X : CELL_0;
+        logic.set_cell_state(pos, symbol);
+        if (logic.check_win() == true) {
+            logic.set_cell_state(pos, symbol == CELL_X ? CELL_0 : CELL_X);
+            if (logic.check_win() == true) {
+                logic.set_cell_state(pos, CELL_EMPTY);
+            }
+        }
+    }
+
+    int nr_X = 0;
+    int nr_0 = 0;
+    for (int i = 0; i < nr_rows; i++) {
+        for (int j = 0; j < nr_columns; j++) {
+            nr_X += logic.get_cell_state({i, j}) == CELL_X;
+            nr_0 += logic.get_cell_state({i, j}) == CELL_0;
+        }
+    }
+    return nr_X == nr_0 ? CELL_X : CELL_0;
+}
+
+// helpers as they were before the scanline rasterizer (one draw call per offset line or per pixel),
+// kept to time the rasterizer against them and to compare the pixels they draw
+int ReferenceRenderThickLine(SDL_Renderer *renderer, SDL_Point start, SDL_Point stop, int thickness) {
+    long slope = LineSlope(start, stop);
+
+    SDL_RenderDrawLine(renderer, start.x, start.y, stop.x, stop.y);
+    for (int i = 0; i < thickness; i++) {
+        if (abs(slope) > 1) {
+            SDL_RenderDrawLine(renderer, start.x + i, start.y, stop.x + i, stop.y);
+            SDL_RenderDrawLine(renderer, start.x - i, start.y, stop.x - i, stop.y);
+        } else {
+            SDL_RenderDrawLine(renderer, start.x, start.y + i, stop.x, stop.y + i);
+            SDL_RenderDrawLine(renderer, start.x, start.y - i, stop.x, stop.y - i);
+        }
+    }
+
+    return 2 * thickness + 1;
+}
+
+int ReferenceRenderX(SDL_Renderer *renderer, SDL_Rect dimensions, int thickness) {
+    int offset = std::min(dimensions.w, dimensions.h) / 10;
+    int nr_calls = 0;
+
+    nr_calls += ReferenceRenderThickLine(renderer, {dimensions.x + offset, dimensions.y + offset},
+        {dimensions.x + dimensions.w - offset, dimensions.y + dimensions.h - offset}, thickness);
+    nr_calls += ReferenceRenderThickLine(renderer, {dimensions.x + offset, dimensions.y + dimensions.h - offset},
+        {dimensions.x + dimensions.w - offset, dimensions.y + offset}, thickness);
+
+    return nr_calls;
+}
+
+int ReferenceRender0(SDL_Renderer *renderer, SDL_Rect dimensions, int thickness) {
+    int nr_calls = 0;
+    SDL_Point center = {dimensions.x + dimensions.w / 2, dimensions.y + dimensions.h / 2};
+    int radius = std::min(dimensions.h, dimensions.w) * 8 / 20;
+
+    for (int i = 0; i < dimensions.w; i++) {
+        for (int j = 0; j < dimensions.h; j++) {
+            SDL_Point cur_point = {dimensions.x + i, dimensions.y + j};
+            long deviation = abs(PointsDist(cur_point, center) - radius);
+
+            if (deviation < 0.5 || deviation < thickness) {
+                SDL_RenderDrawPoint(renderer, cur_point.x, cur_point.y);
+                nr_calls++;
+            }
+        }
+    }
+
+    return nr_calls;
+}
+
+// draws with both functions on a surface cleared to black, counts differing and shared pixels
+template <typename DrawNew, typename DrawReference>
+pixel_comparison compare_pixels(SDL_Renderer* renderer, SDL_Surface* surface, DrawNew draw_new,
+    DrawReference draw_reference) {
+
+    int nr_pixels = surface->w * surface->h;
+    std::vector<Uint32> reference_pixels(nr_pixels);
+    pixel_comparison comparison = {0, 0, 0};
+    Uint32 black = SDL_MapRGBA(surface->format, 0, 0, 0, 255);
+
+    for (int pass = 0; pass < 2; pass++) {
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+        SDL_RenderClear(renderer);
+        SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+        if (pass == 0) {
+            draw_reference();
+        } else {
+            draw_new();
+        }
+        SDL_RenderFlush(renderer);
+
+        // rows of the surface may be padded, so pixels are read row by row
+        for (int y = 0; y < surface->h; y++) {
+            Uint32* row = (Uint32*)((Uint8*)surface->pixels + y * surface->pitch);
+            for (int x = 0; x < surface->w; x++) {
+                Uint32 reference = reference_pixels[y * surface->w + x];
+                if (pass == 0) {
+                    reference_pixels[y * surface->w + x] = row[x];
+                    comparison.nr_reference += row[x] != black;
+                } else {
+                    comparison.nr_different += row[x] != reference;
+                    comparison.nr_covered += row[x] != black && reference != black;
+                }
+            }
+        }
+    }
+
+    return comparison;
+}
+
+// stores a comparison in result, exact is true if no pixel may differ
+void check_pixels(bench_result& result, const pixel_comparison& comparison, bool exact) {
+    result.pixel_diff = comparison.nr_different;
+    result.coverage = comparison.nr_reference > 0 ? 1.0 * comparison.nr_covered / comparison.nr_reference : 1;
+
+    if (exact == true) {
+        result.note = "must match reference exactly";
+        result.pixels_ok = comparison.nr_different == 0;
+    } else {
+        result.note = "diagonals intentionally thicker than reference, coverage >= "
+            + std::to_string(MIN_STROKE_COVERAGE);
+        result.pixels_ok = result.coverage >= MIN_STROKE_COVERAGE;
+    }
+}
+
+void bench_engine(std::vector<bench_result>& results, int size) {
+    int nr_win_line = std::min(size, 5);
+    std::string board = std::to_string(size) + "x" + std::to_string(size) + " k=" + std::to_string(nr_win_line);
+    std::mt19937 rng(size);
+    const char* direction_names[] = {"check_win_row", "check_win_column", "check_win_diag1", "check_win_diag2"};
+
+    // half full board for the win checks and the cell updates
+    GameLogic logic(size, size, nr_win_line);
+    fill_position(logic, rng, size * size / 2);
+    std::vector<cell_pos> used_cells;
+    std::vector<cell_pos> empty_cells = logic.get_available_cells();
+    for (int i = 0; i < size; i++) {
+        for (int j = 0; j < size; j++) {
+            if (logic.get_cell_state({i, j}) != CELL_EMPTY) {
+                used_cells.push_back({i, j});
+            }
+        }
+    }
+
+    for (int dir = DIR_ROW; dir <= DIR_DIAG2; dir++) {
+        run_bench(results, direction_names[dir], board, [&](long long i) {
+            bench_sink = logic.check_win_direction(used_cells[i % used_cells.size()], (win_direction)dir);
+        });
+    }
+    // check_win only reads what set_cell_state found, so it is timed with the move it checks
+    // (a call is one mark, its check and its revert, compare with set_cell_state_pair)
+    run_bench(results, "set_cell_state_check_win", board, [&](long long i) {
+        cell_pos pos = empty_cells[i % empty_cells.size()];
+        logic.set_cell_state(pos, CELL_X);
+        bench_sink = logic.check_win();
+        logic.set_cell_state(pos, CELL_EMPTY);
+    });
+    run_bench(results, "get_available_cells", board, [&](long long) {
+        bench_sink = logic.get_available_cells().size();
+    });
+    std::vector<cell_pos> buffer;
+    run_bench(results, "get_available_cells_buffer", board, [&](long long) {
+        logic.get_available_cells(buffer);
+        bench_sink = buffer.size();
+    });
+    // a call is one mark and its revert (the way searches use it)
+    run_bench(results, "set_cell_state_pair", board, [&](long long i) {
+        cell_pos pos = empty_cells[i % empty_cells.size()];
+        logic.set_cell_state(pos, CELL_X);
+        logic.set_cell_state(pos, CELL_EMPTY);
+    });
+
+    // plain minimax of the whole remaining game, no transposition table or shortcuts
+    GameLogic minimax_logic(size, size, nr_win_line);
+    cell_state to_move = fill_position(minimax_logic, rng, MINIMAX_EMPTY_CELLS);
+    std::vector<cell_state> symbols_order = {CELL_X, CELL_0};
+    GameModifiers modifiers;
+    modifiers.robot_search = SEARCH_MINIMAX;
+    modifiers.tt_size_mb = 0;
+    modifiers.robot_threads = 1;
+    modifiers.robot_symmetry = false;
+    modifiers.robot_perfect_table = false;
+    Robot robot(to_move, &minimax_logic, nullptr, HARD, symbols_order, modifiers);
+
+    run_bench(results, "robot_minimax", board, [&](long long) {
+        cell_pos pos;
+        robot.compute_action(pos);
+        bench_sink = pos.row * size + pos.column;
+    });
+
+    // shapes of a cell of the rendering benchmarks, without drawing them (no renderer needed)
+    int cell_size = SURFACE_SIZE / size;
+    SDL_Rect cell = {0, 0, cell_size, cell_size};
+    std::vector<SDL_Rect> spans;
+    run_bench(results, "RasterizeRing", board, [&](long long) {
+        spans.clear();
+        RasterizeRing(spans, cell, SYMBOL_THICKNESS);
+        bench_sink = spans.size();
+    });
+    run_bench(results, "RasterizeStroke", board, [&](long long) {
+        spans.clear();
+        RasterizeStroke(spans, {0, 0}, {size * cell_size, size * cell_size}, LINE_THICKNESS);
+        bench_sink = spans.size();
+    });
+}
+
+void bench_rendering(std::vector<bench_result>& results, SDL_Renderer* renderer, SDL_Surface* surface, int size) {
+    std::string board = std::to_string(size) + "x" + std::to_string(size);
+    int cell_size = SURFACE_SIZE / size;
+    SDL_Rect cell = {0, 0, cell_size, cell_size};
+    SDL_Point start = {0, 0};
+    SDL_Point stop = {size * cell_size, size * cell_size};
+
+    // every helper is timed next to its reference, the pixel difference is stored with the new helper
+    // (the win line across the whole board is the longest line the grid draws)
+    int nr_calls = 0;
+    run_bench(results, "RenderThickLine", board, [&](long long) {
+        nr_calls = RenderThickLine(renderer, start, stop, LINE_THICKNESS);
+    });
+    results.back().draw_calls = nr_calls;
+    check_pixels(results.back(), compare_pixels(renderer, surface,
+        [&]() { RenderThickLine(renderer, start, stop, LINE_THICKNESS); },
+        [&]() { ReferenceRenderThickLine(renderer, start, stop, LINE_THICKNESS); }), false);
+    run_bench(results, "RenderThickLine_reference", board, [&](long long) {
+        nr_calls = ReferenceRenderThickLine(renderer, start, stop, LINE_THICKNESS);
+    });
+    results.back().draw_calls = nr_calls;
+
+    run_bench(results, "RenderX", board, [&](long long) {
+        nr_calls = RenderX(renderer, cell, SYMBOL_THICKNESS);
+    });
+    results.back().draw_calls = nr_calls;
+    check_pixels(results.back(), compare_pixels(renderer, surface,
+        [&]() { RenderX(renderer, cell, SYMBOL_THICKNESS); },
+        [&]() { ReferenceRenderX(renderer, cell, SYMBOL_THICKNESS); }), false);
+    run_bench(results, "RenderX_reference", board, [&](long long) {
+        nr_calls = ReferenceRenderX(renderer, cell, SYMBOL_THICKNESS);
+    });
+    results.back().draw_calls = nr_calls;
+
+    run_bench(results, "Render0", board, [&](long long) {
+        nr_calls = Render0(renderer, cell, SYMBOL_THICKNESS);
+    });
+    results.back().draw_calls = nr_calls;
+    check_pixels(results.back(), compare_pixels(renderer, surface,
+        [&]() { Render0(renderer, cell, SYMBOL_THICKNESS); },
+        [&]() { ReferenceRender0(renderer, cell, SYMBOL_THICKNESS); }), true);
+    run_bench(results, "Render0_reference", board, [&](long long) {
+        nr_calls = ReferenceRender0(renderer, cell, SYMBOL_THICKNESS);
+    });
+    results.back().draw_calls = nr_calls;
+
+    // whole frame of a half full grid (colors of the default game modifiers)
+    GameModifiers modifiers;
+    GameGrid grid(renderer, size, size, modifiers.grid_color, modifiers.color_X, modifiers.color_0,
+        modifiers.color_Z, modifiers.color_win);
+    for (int i = 0; i < size; i++) {
+        for (int j = 0; j < size; j++) {
+            if ((i + j) % 2 == 0) {
+                grid.set_cell_state({i, j}, (i + j) % 4 == 0 ? CELL_X : CELL_0);
+            }
+        }
+    }
+    run_bench(results, "draw_grid", board, [&](long long) {
+        grid.draw_grid();
+    });
+    results.back().draw_calls = grid.get_nr_draw_calls();
+}
+
+void print_csv(const std::vector<bench_result>& results) {
+    std::cout << "benchmark,board,iterations,ns_per_op,draw_calls,pixel_diff,coverage,note\n";
+    for (const bench_result& result : results) {
+        std::cout << result.name << "," << result.board << "," << result.iterations << ","
+            << result.ns_per_op << "," << result.draw_calls << "," << result.pixel_diff << ","
+            << result.coverage << "," << result.note << "\n";
+    }
+}
+
+void print_json(const std::vector<bench_result>& results) {
+    std::cout << "[\n";
+    for (int i = 0; i < (int)results.size(); i++) {
+        const bench_result& result = results[i];
+        std::cout << "  {\"benchmark\": \"" << result.name << "\", \"board\": \"" << result.board
+            << "\", \"iterations\": " << result.iterations << ", \"ns_per_op\": " << result.ns_per_op
+            << ", \"draw_calls\": " << result.draw_calls << ", \"pixel_diff\": " << result.pixel_diff
+            << ", \"coverage\": " << result.coverage << ", \"note\": \"" << result.note << "\"}"
+            << (i + 1 < (int)results.size() ? "," : "") << "\n";
+    }
+    std::cout << "]\n";
+}
+
+int main(int argc, char* argv[]) {
+    bool json = argc > 1 && std::string(argv[1]) == "json";
+    std::vector<bench_result> results;
+
+    for (int size : BOARD_SIZES) {
+        bench_engine(results, size);
+    }
+
+    // software renderer draws into memory, no window is needed
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, SURFACE_SIZE, SURFACE_SIZE, 32, SDL_PIXELFORMAT_ARGB8888);
+    SDL_Renderer* renderer = surface != nullptr ? SDL_CreateSoftwareRenderer(surface) : nullptr;
+    if (renderer == nullptr) {
+        LOG_ERROR("Software renderer could not be created, rendering is not timed: " << SDL_GetError() << "\n");
+    } else {
+        SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+        for (int size : BOARD_SIZES) {
+            bench_rendering(results, renderer, surface, size);
+        }
+        SDL_DestroyRenderer(renderer);
+    }
+    if (surface != nullptr) {
+        SDL_FreeSurface(surface);
+    }
+
+    if (json == true) {
+        print_json(results);
+    } else {
+        print_csv(results);
+    }
+
+    bool pixels_ok = true;
+    for (const bench_result& result : results) {
+        if (result.pixels_ok == false) {
+            LOG_ERROR(result.name << " " << result.board << " is out of tolerance: " << result.pixel_diff
+                << " pixels differ, coverage " << result.coverage << " (" << result.note << ")\n");
+            pixels_ok = false;
+        }
+    }
+
+    return pixels_ok ? 0 : 1;
+}
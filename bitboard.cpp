@@ -0,0 +1,19 @@
+#include <vector>
+
+#include "custom/bitboard.h"
+
+Bitboard::Bitboard() {};
+
+Bitboard::Bitboard(int nr_bits) {
+    resize(nr_bits);
+}
+
+void Bitboard::resize(int nr_bits) {
+    words.assign((nr_bits + 63) / 64, 0);
+}
+
+void Bitboard::clear() {
+    for (unsigned long long& word : words) {
+        word = 0;
+    }
+}
@@ -2,9 +2,11 @@
 
 #include <iostream>
 #include <vector>
+#include <cmath>
 
 #include "custom/game_interface.h"
 #include "custom/utils.h"
+#include "custom/logger.h"
 
 SDL_Renderer* GameWindow::get_renderer() {
     return renderer;
@@ -14,12 +16,16 @@ SDL_Window* GameWindow::get_window() {
     return window;
 }
 
+SDL_Texture* GameWindow::get_background() {
+    return background;
+}
+
 GameWindow::GameWindow() {
     display_index = 0;
 
     // initialize SDL related aspects
     if (SDL_Init(SDL_INIT_VIDEO) < 0) {
-        std::cerr << "Could not initialize SDL video: " << SDL_GetError() << std::endl;
+        LOG_ERROR("Could not initialize SDL video: " << SDL_GetError() << "\n");
     }
 
     window = SDL_CreateWindow("TicTacToe", 
@@ -30,7 +36,7 @@ GameWindow::GameWindow() {
         SDL_WINDOW_SHOWN | SDL_WINDOW_RESIZABLE // SDL_WINDOW_FULLSCREEN
     );
     if (window == nullptr) {
-        std::cerr << "Could not create window: " << SDL_GetError() << std::endl;
+        LOG_ERROR("Could not create window: " << SDL_GetError() << "\n");
     }
     // get window dimensions
     SDL_GetWindowSize(window, &viewport.w, &viewport.h);
@@ -42,19 +48,21 @@ GameWindow::GameWindow() {
         SDL_RENDERER_ACCELERATED
     );
     if (renderer == nullptr) {
-        std::cerr << "Could not create renderer: " << SDL_GetError() << std::endl; 
+        LOG_ERROR("Could not create renderer: " << SDL_GetError() << "\n"); 
     }
 
-    background = CreateSizedTextureFromBMP(renderer, "src/assets/background.bmp", viewport.w, viewport.h);
+    background = CreateTextureFromBMP(renderer, "src/assets/background.bmp");
 }
 
-void GameWindow::prepare_render() { // use before updating visual elements and render
+void GameWindow::prepare_render(bool draw_background) { // use before updating visual elements and render
     // clear renderer before drawing
     SDL_SetRenderDrawColor(renderer, 0, 0, 0, SDL_ALPHA_OPAQUE); // black background
     SDL_RenderClear(renderer);
 
     // display background in renderer
-    SDL_RenderCopy(renderer, background, nullptr, nullptr);
+    if (draw_background == true) {
+        SDL_RenderCopy(renderer, background, nullptr, nullptr);
+    }
 }
 
 void GameWindow::render() { // use after updating visual elements and prepare_render
@@ -63,19 +71,18 @@ void GameWindow::render() { // use after updating visual elements and prepare_re
 }
 
 void GameWindow::handle_resize() {
-    // destroy old background
-    if (background != nullptr) {
-        SDL_DestroyTexture(background);
-    }
-
-    // update renderer
+    // update renderer (background keeps its texture, it is scaled when copied)
     SDL_GetWindowSize(window, &viewport.w, &viewport.h);
     viewport.x = 0;
     viewport.y = 0;
     SDL_RenderSetViewport(renderer, &viewport);
+}
 
-    // prepare new background
-    background = CreateSizedTextureFromBMP(renderer, "src/assets/background.bmp", viewport.w, viewport.h);
+void GameWindow::reload_background() {
+    if (background != nullptr) {
+        SDL_DestroyTexture(background);
+    }
+    background = CreateTextureFromBMP(renderer, "src/assets/background.bmp");
 }
 
 GameWindow::~GameWindow() {
@@ -114,12 +121,201 @@ void GameGrid::update_grid_dim() {
     int max_cell_dy = (get_vertical_fit_ratio(viewport.h) - 2 * margins) / grid_nr_rows;
     max_cell_dy = std::max(max_cell_dy, 0);
     
-    cell_size = std::min(max_cell_dx, max_cell_dy);
+    // boards too big to fit start at the smallest zoom (centered, the rest is reached by panning)
+    cell_size = std::max(std::min(max_cell_dx, max_cell_dy), min_cell_size);
     grid_dim.w = cell_size * grid_nr_columns;
     grid_dim.h = cell_size * grid_nr_rows;
 
-    grid_dim.x = std::max((viewport.w - grid_dim.w) / 2, 0); 
-    grid_dim.y = std::max((get_vertical_fit_ratio(viewport.h) - grid_dim.h) / 2, 0);
+    grid_dim.x = (viewport.w - grid_dim.w) / 2; 
+    grid_dim.y = (get_vertical_fit_ratio(viewport.h) - grid_dim.h) / 2;
+    clamp_camera();
+
+    build_symbol_sprites();
+    build_static_layer();
+    camera_moved = false;
+}
+
+void GameGrid::clamp_camera() {
+    SDL_Rect viewport;
+    SDL_RenderGetViewport(renderer_used, &viewport);
+
+    // at least "margins" pixels of the grid stay in the window on each axis
+    grid_dim.x = std::min(std::max(grid_dim.x, margins - grid_dim.w), viewport.w - margins);
+    grid_dim.y = std::min(std::max(grid_dim.y, margins - grid_dim.h), viewport.h - margins);
+}
+
+// cells of one axis inside [0, view_size) for a grid starting at origin
+static void GetVisibleRange(int origin, int view_size, int cell_size, int nr_cells, int& first, int& last) {
+    first = origin < 0 ? -origin / cell_size : 0;
+    last = view_size - 1 - origin < 0 ? -1 : std::min((view_size - 1 - origin) / cell_size, nr_cells - 1);
+}
+
+void GameGrid::get_visible_cells(cell_pos& first, cell_pos& last) {
+    SDL_Rect viewport;
+    SDL_RenderGetViewport(renderer_used, &viewport);
+
+    GetVisibleRange(grid_dim.x, viewport.w, cell_size, grid_nr_columns, first.column, last.column);
+    GetVisibleRange(grid_dim.y, viewport.h, cell_size, grid_nr_rows, first.row, last.row);
+}
+
+SDL_Point GameGrid::get_cell_center(cell_pos pos) {
+    return {grid_dim.x + pos.column * cell_size + cell_size / 2, grid_dim.y + pos.row * cell_size + cell_size / 2};
+}
+
+void GameGrid::pan_camera(int dx, int dy) {
+    grid_dim.x += dx;
+    grid_dim.y += dy;
+    clamp_camera();
+    camera_moved = true;
+}
+
+void GameGrid::zoom_camera(SDL_Point focus, int steps) {
+    SDL_Rect viewport;
+    SDL_RenderGetViewport(renderer_used, &viewport);
+
+    // every step scales cells by 1.25 (at least by a pixel), a cell is at most as big as the window
+    int max_cell_size = std::max(std::min(viewport.w, viewport.h), min_cell_size);
+    int new_cell_size = cell_size * std::pow(1.25, steps) + 0.5;
+    if (new_cell_size == cell_size) {
+        new_cell_size += steps > 0 ? 1 : -1;
+    }
+    new_cell_size = std::min(std::max(new_cell_size, min_cell_size), max_cell_size);
+    if (new_cell_size == cell_size) {
+        return;
+    }
+
+    // grid is scaled around focus
+    grid_dim.x = focus.x - (long long)(focus.x - grid_dim.x) * new_cell_size / cell_size;
+    grid_dim.y = focus.y - (long long)(focus.y - grid_dim.y) * new_cell_size / cell_size;
+    cell_size = new_cell_size;
+    grid_dim.w = cell_size * grid_nr_columns;
+    grid_dim.h = cell_size * grid_nr_rows;
+    clamp_camera();
+    camera_moved = true;
+}
+
+void GameGrid::handle_render_reset(bool device_lost) {
+    if (device_lost == true) {
+        sprites_cell_size = -1; // sprites are drawn again even if the cell size is the same
+        build_symbol_sprites();
+        destroy_lod_texture(); // created again from grid_data when it is needed
+    }
+    build_static_layer();
+}
+
+bool GameGrid::has_static_layer() {
+    return static_layer != nullptr;
+}
+
+void GameGrid::set_background(SDL_Texture* texture) {
+    background = texture;
+}
+
+void GameGrid::build_static_layer() {
+    SDL_Rect viewport;
+    SDL_RenderGetViewport(renderer_used, &viewport);
+
+    // texture is kept if the window size did not change (only its content is drawn again)
+    if (static_layer != nullptr && (viewport.w != static_layer_dim.w || viewport.h != static_layer_dim.h)) {
+        destroy_static_layer();
+    }
+    if (viewport.w <= 0 || viewport.h <= 0 || SDL_RenderTargetSupported(renderer_used) == SDL_FALSE) {
+        return;
+    }
+    if (static_layer == nullptr) {
+        static_layer = SDL_CreateTexture(renderer_used, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET,
+            viewport.w, viewport.h);
+        if (static_layer == nullptr) {
+            LOG_ERROR("Could not create grid layer, grid is drawn every frame: " << SDL_GetError() << "\n");
+            return;
+        }
+    }
+    static_layer_dim = {0, 0, viewport.w, viewport.h};
+
+    // grid coordinates are relative to the viewport, so they are the same in the texture
+    SDL_Texture* old_target = SDL_GetRenderTarget(renderer_used);
+    if (SDL_SetRenderTarget(renderer_used, static_layer) < 0) {
+        LOG_ERROR("Could not draw grid layer, grid is drawn every frame: " << SDL_GetError() << "\n");
+        destroy_static_layer();
+        return;
+    }
+
+    SDL_SetRenderDrawColor(renderer_used, 0, 0, 0, SDL_ALPHA_OPAQUE); // same as the window clear color
+    SDL_RenderClear(renderer_used);
+    if (background != nullptr) {
+        SDL_RenderCopy(renderer_used, background, nullptr, nullptr);
+    }
+    draw_grid_lines();
+
+    SDL_SetRenderTarget(renderer_used, old_target);
+}
+
+void GameGrid::destroy_static_layer() {
+    if (static_layer != nullptr) {
+        SDL_DestroyTexture(static_layer);
+        static_layer = nullptr;
+    }
+}
+
+void GameGrid::build_symbol_sprites() {
+    if (cell_size == sprites_cell_size) {
+        return;
+    }
+    destroy_symbol_sprites();
+    sprites_cell_size = cell_size;
+    if (cell_size <= 0) {
+        return;
+    }
+
+    SDL_Color colors[3];
+    colors[CELL_X] = color_X;
+    colors[CELL_0] = color_0;
+    colors[CELL_Z] = color_Z;
+
+    // symbols are drawn by a software renderer on a transparent surface, then uploaded once
+    for (int symbol = CELL_X; symbol <= CELL_Z; symbol++) {
+        SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, cell_size, cell_size, 32, SDL_PIXELFORMAT_ARGB8888);
+        SDL_Renderer* sprite_renderer = surface != nullptr ? SDL_CreateSoftwareRenderer(surface) : nullptr;
+
+        if (sprite_renderer == nullptr) {
+            LOG_ERROR("Could not draw symbol sprite: " << SDL_GetError() << "\n");
+        } else {
+            SDL_Rect cell_dim = {0, 0, cell_size, cell_size};
+
+            SDL_SetRenderDrawColor(sprite_renderer, 0, 0, 0, SDL_ALPHA_TRANSPARENT);
+            SDL_RenderClear(sprite_renderer);
+            SDL_SetRenderDrawColor(sprite_renderer,
+                colors[symbol].r, colors[symbol].g, colors[symbol].b, colors[symbol].a
+            );
+            switch (symbol) {
+                case CELL_X: RenderX(sprite_renderer, cell_dim, thickness * 2); break;
+                case CELL_0: Render0(sprite_renderer, cell_dim, thickness * 2); break;
+                case CELL_Z: RenderZ(sprite_renderer, cell_dim, thickness * 2); break;
+                default: break;
+            }
+            SDL_DestroyRenderer(sprite_renderer);
+
+            symbol_sprites[symbol] = SDL_CreateTextureFromSurface(renderer_used, surface);
+            if (symbol_sprites[symbol] == nullptr) {
+                LOG_ERROR("Could not create symbol texture: " << SDL_GetError() << "\n");
+            } else {
+                SDL_SetTextureBlendMode(symbol_sprites[symbol], SDL_BLENDMODE_BLEND);
+            }
+        }
+
+        if (surface != nullptr) {
+            SDL_FreeSurface(surface);
+        }
+    }
+}
+
+void GameGrid::destroy_symbol_sprites() {
+    for (int symbol = CELL_X; symbol <= CELL_Z; symbol++) {
+        if (symbol_sprites[symbol] != nullptr) {
+            SDL_DestroyTexture(symbol_sprites[symbol]);
+            symbol_sprites[symbol] = nullptr;
+        }
+    }
 }
 
 void GameGrid::draw_cell(cell_pos pos, cell_state symbol_used) {
@@ -130,34 +326,60 @@ void GameGrid::draw_cell(cell_pos pos, cell_state symbol_used) {
     cell_dim.w = cell_size;
     cell_dim.h = cell_size;
 
+    if (symbol_used == CELL_EMPTY) {
+        return;
+    }
+
+    // sprite of the symbol is only copied (symbols are rasterized every frame only without sprites)
+    if (symbol_sprites[symbol_used] != nullptr) {
+        SDL_RenderCopy(renderer_used, symbol_sprites[symbol_used], nullptr, &cell_dim);
+        nr_draw_calls++;
+        return;
+    }
+
     switch (symbol_used) {
         case CELL_X:
             SDL_SetRenderDrawColor(renderer_used, 
                 color_X.r, color_X.g, color_X.b, color_X.a
             );
-            RenderX(renderer_used, cell_dim, thickness * 2); // we use double thickness for symbols
+            nr_draw_calls += RenderX(renderer_used, cell_dim, thickness * 2); // we use double thickness for symbols
             break;
         case CELL_0:
             SDL_SetRenderDrawColor(renderer_used, 
                 color_0.r, color_0.g, color_0.b, color_0.a
             );
-            Render0(renderer_used, cell_dim, thickness * 2); // we use double thickness for symbols
+            nr_draw_calls += Render0(renderer_used, cell_dim, thickness * 2); // we use double thickness for symbols
             break;
         case CELL_Z:
             SDL_SetRenderDrawColor(renderer_used, 
                 color_Z.r, color_Z.g, color_Z.b, color_Z.a
             );
-            RenderZ(renderer_used, cell_dim, thickness * 2); // we use double thickness for symbols
+            nr_draw_calls += RenderZ(renderer_used, cell_dim, thickness * 2); // we use double thickness for symbols
             break;
         default: break;
     }
 }
 
 void GameGrid::draw_win_line() {
+    SDL_Point start_win = get_cell_center(win_cells.start_cell);
+    SDL_Point stop_win = get_cell_center(win_cells.stop_cell);
+
+    if (batched_rendering == true) {
+        win_vertices.clear();
+        AddThickLineQuad(win_vertices, start_win, stop_win, thickness, color_win);
+        if (SDL_RenderGeometry(renderer_used, nullptr, win_vertices.data(), win_vertices.size(), nullptr, 0) == 0) {
+            nr_draw_calls++;
+            return;
+        }
+
+        LOG_ERROR("Batched rendering failed, drawing line by line: " << SDL_GetError() << "\n");
+        batched_rendering = false;
+    }
+
     SDL_SetRenderDrawColor(renderer_used,
         color_win.r, color_win.g, color_win.b, color_win.a
     );
-    RenderThickLine(renderer_used, start_win, stop_win, thickness);
+    nr_draw_calls += RenderThickLine(renderer_used, start_win, stop_win, thickness);
 }
 
 void GameGrid::clear_grid_data() {
@@ -168,19 +390,98 @@ void GameGrid::clear_grid_data() {
     }
 
     game_won = false;
+    if (lod_texture != nullptr) {
+        build_lod_texture(); // whole texture is cleared
+    }
 }
 
 void GameGrid::set_cell_state(cell_pos pos, cell_state state) {
     grid_data[pos.row][pos.column] = state;
+
+    // only the texel of this cell is uploaded
+    if (lod_texture != nullptr) {
+        SDL_Rect texel = {pos.column, pos.row, 1, 1};
+        Uint32 color = get_lod_texel(state);
+        if (SDL_UpdateTexture(lod_texture, &texel, &color, sizeof(color)) < 0) {
+            LOG_ERROR("Could not update cell texel: " << SDL_GetError() << "\n");
+        }
+    }
 }
 
-void GameGrid::set_winner(grid_line_data data) {
-    start_win.x = grid_dim.x + data.start_cell.column * cell_size + cell_size / 2;
-    start_win.y = grid_dim.y + data.start_cell.row * cell_size + cell_size / 2;
+Uint32 GameGrid::get_lod_texel(cell_state state) {
+    SDL_Color color;
+    switch (state) {
+        case CELL_X: color = color_X; break;
+        case CELL_0: color = color_0; break;
+        case CELL_Z: color = color_Z; break;
+        default: return 0; // transparent
+    }
+    return ((Uint32)color.a << 24) | ((Uint32)color.r << 16) | ((Uint32)color.g << 8) | (Uint32)color.b;
+}
+
+bool GameGrid::use_lod() {
+    if (cell_size >= lod_cell_size || lod_supported == false) {
+        return false;
+    }
+    if (lod_texture == nullptr) {
+        build_lod_texture();
+    }
+    return lod_texture != nullptr;
+}
+
+void GameGrid::build_lod_texture() {
+    if (lod_texture == nullptr) {
+        lod_texture = SDL_CreateTexture(renderer_used, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING,
+            grid_nr_columns, grid_nr_rows);
+        if (lod_texture == nullptr) {
+            LOG_ERROR("Could not create cell texture, symbols are drawn at every size: " << SDL_GetError() << "\n");
+            lod_supported = false;
+            return;
+        }
+        SDL_SetTextureBlendMode(lod_texture, SDL_BLENDMODE_BLEND);
+        SDL_SetTextureScaleMode(lod_texture, SDL_ScaleModeNearest); // cells keep sharp edges
+    }
+
+    void* pixels;
+    int pitch;
+    if (SDL_LockTexture(lod_texture, nullptr, &pixels, &pitch) < 0) {
+        LOG_ERROR("Could not fill cell texture, symbols are drawn at every size: " << SDL_GetError() << "\n");
+        destroy_lod_texture();
+        lod_supported = false;
+        return;
+    }
+    for (int i = 0; i < grid_nr_rows; i++) {
+        Uint32* row = (Uint32*)((Uint8*)pixels + i * pitch);
+        for (int j = 0; j < grid_nr_columns; j++) {
+            row[j] = get_lod_texel(grid_data[i][j]);
+        }
+    }
+    SDL_UnlockTexture(lod_texture);
+}
 
-    stop_win.x = grid_dim.x + data.stop_cell.column * cell_size + cell_size / 2;
-    stop_win.y = grid_dim.y + data.stop_cell.row * cell_size + cell_size / 2;
+void GameGrid::destroy_lod_texture() {
+    if (lod_texture != nullptr) {
+        SDL_DestroyTexture(lod_texture);
+        lod_texture = nullptr;
+    }
+}
 
+void GameGrid::draw_lod() {
+    cell_pos first, last;
+    get_visible_cells(first, last);
+    if (first.row > last.row || first.column > last.column) {
+        return;
+    }
+
+    SDL_Rect texels = {first.column, first.row, last.column - first.column + 1, last.row - first.row + 1};
+    SDL_Rect cells = {grid_dim.x + first.column * cell_size, grid_dim.y + first.row * cell_size,
+        texels.w * cell_size, texels.h * cell_size};
+    SDL_RenderCopy(renderer_used, lod_texture, &texels, &cells);
+    nr_draw_calls++;
+}
+
+void GameGrid::set_winner(grid_line_data data) {
+    win_cells = data;
     game_won = true;
 }
 
@@ -190,12 +491,12 @@ void GameGrid::set_mouse_poz(SDL_Point point) {
 
 // function to check whether mouse hovers over a valid cell (saves row and column)
 bool GameGrid::check_mouse_cell(cell_pos& pos) {
-    // first check whether mouse is inside grid
-    if (mouse_poz.x < grid_dim.x || mouse_poz.x > grid_dim.x + grid_dim.w) {
+    // first check whether mouse is inside grid (grid_dim follows the camera)
+    if (mouse_poz.x < grid_dim.x || mouse_poz.x >= grid_dim.x + grid_dim.w) {
         return false;
     }
 
-    if (mouse_poz.y < grid_dim.y || mouse_poz.y > grid_dim.y + grid_dim.h) {
+    if (mouse_poz.y < grid_dim.y || mouse_poz.y >= grid_dim.y + grid_dim.h) {
         return false;
     }
 
@@ -216,47 +517,141 @@ GameGrid::GameGrid(SDL_Renderer* renderer, int grd_nr_rows, int grd_nr_cols,
         grid_data[i].resize(grid_nr_columns);
     }
 
+    for (int symbol = CELL_X; symbol <= CELL_Z; symbol++) {
+        symbol_sprites[symbol] = nullptr;
+    }
+    sprites_cell_size = -1;
+    background = nullptr;
+    static_layer = nullptr;
+    static_layer_dim = {0, 0, 0, 0};
+    batched_rendering = true;
+    nr_draw_calls = 0;
+    camera_moved = false;
+    lod_texture = nullptr;
+    lod_supported = true;
+
     // prepare state of game
     clear_grid_data();
     update_grid_dim();
 }
 
-GameGrid::~GameGrid() {};
+GameGrid::~GameGrid() {
+    destroy_symbol_sprites();
+    destroy_static_layer();
+    destroy_lod_texture();
+};
 
 void GameGrid::draw_grid() {
-    SDL_SetRenderDrawColor(renderer_used, 
-        color_grid.r, color_grid.g, color_grid.b, color_grid.a
-    );
+    nr_draw_calls = 0;
 
-    // draw vertical lines
-    for (int i = 0; i <= grid_nr_columns; i++) {
-        int x_poz = grid_dim.x + i * cell_size; // const x coord for each vert line
-        RenderThickLine(renderer_used, 
-            {x_poz, grid_dim.y}, 
-            {x_poz, grid_dim.y + grid_dim.h}, 
-            thickness
-        );
+    // camera may have moved many times since the last frame, layers are drawn once
+    if (camera_moved == true) {
+        build_symbol_sprites();
+        build_static_layer();
+        camera_moved = false;
     }
 
-    // draw horizontal lines
-    for (int i = 0; i <= grid_nr_rows; i++) {
-        int y_poz = grid_dim.y + i * cell_size; // const y coord for each horiz line
-        RenderThickLine(renderer_used, 
-            {grid_dim.x, y_poz}, 
-            {grid_dim.x + grid_dim.w, y_poz},
-            thickness
-        ); 
+    // background and grid lines only change with the layout
+    if (static_layer != nullptr) {
+        SDL_RenderCopy(renderer_used, static_layer, nullptr, nullptr);
+        nr_draw_calls++;
+    } else {
+        draw_grid_lines();
     }
 
-    // draw "X" and "0" symbols
-    for (int i = 0; i < grid_nr_rows; i++) {
-        for (int j = 0; j < grid_nr_columns; j++) {
-            draw_cell({i, j}, grid_data[i][j]);
-        }
+    // draw "X" and "0" symbols (small cells only get their color)
+    if (use_lod() == true) {
+        draw_lod();
+    } else {
+        draw_symbols();
     }
 
     // draw cross line for winner if case
     if (game_won == true) {
         draw_win_line();
     }
-}
\ No newline at end of file
+}
+
+void GameGrid::draw_grid_lines() {
+    cell_pos first, last;
+    get_visible_cells(first, last);
+    line_rects.clear();
+    if (first.row > last.row || first.column > last.column) {
+        return;
+    }
+
+    // only lines around visible cells, as long as the visible part of the grid
+    int left = grid_dim.x + first.column * cell_size;
+    int top = grid_dim.y + first.row * cell_size;
+    int width = (last.column - first.column + 1) * cell_size;
+    int height = (last.row - first.row + 1) * cell_size;
+    // lines would cover cells drawn from lod_texture, only the border of the grid is kept
+    bool border_only = use_lod();
+    for (int i = first.column; i <= last.column + 1; i++) {
+        if (border_only == true && i != 0 && i != grid_nr_columns) {
+            continue;
+        }
+        int x_poz = grid_dim.x + i * cell_size; // const x coord for each vert line
+        line_rects.push_back({x_poz - thickness + 1, top, 2 * thickness - 1, height + 1});
+    }
+    for (int i = first.row; i <= last.row + 1; i++) {
+        if (border_only == true && i != 0 && i != grid_nr_rows) {
+            continue;
+        }
+        int y_poz = grid_dim.y + i * cell_size; // const y coord for each horiz line
+        line_rects.push_back({left, y_poz - thickness + 1, width + 1, 2 * thickness - 1});
+    }
+
+    SDL_SetRenderDrawColor(renderer_used, 
+        color_grid.r, color_grid.g, color_grid.b, color_grid.a
+    );
+    SDL_RenderFillRects(renderer_used, line_rects.data(), line_rects.size());
+    nr_draw_calls++;
+}
+
+void GameGrid::draw_symbols() {
+    cell_pos first, last;
+    get_visible_cells(first, last); // cells outside the window are skipped
+
+    for (int symbol = CELL_X; symbol <= CELL_Z; symbol++) {
+        symbol_vertices.clear();
+
+        for (int i = first.row; i <= last.row; i++) {
+            for (int j = first.column; j <= last.column; j++) {
+                if (grid_data[i][j] != symbol) {
+                    continue;
+                }
+                if (batched_rendering == false || symbol_sprites[symbol] == nullptr) {
+                    draw_cell({i, j}, (cell_state)symbol);
+                    continue;
+                }
+                AddTexturedQuad(symbol_vertices,
+                    {grid_dim.x + j * cell_size, grid_dim.y + i * cell_size, cell_size, cell_size});
+            }
+        }
+
+        if (symbol_vertices.empty() == true) {
+            continue;
+        }
+        if (SDL_RenderGeometry(renderer_used, symbol_sprites[symbol], symbol_vertices.data(),
+            symbol_vertices.size(), nullptr, 0) == 0) {
+            nr_draw_calls++;
+            continue;
+        }
+
+        // batch was not drawn, its cells are copied one by one from now on
+        LOG_ERROR("Batched rendering failed, drawing symbols one by one: " << SDL_GetError() << "\n");
+        batched_rendering = false;
+        for (int i = first.row; i <= last.row; i++) {
+            for (int j = first.column; j <= last.column; j++) {
+                if (grid_data[i][j] == symbol) {
+                    draw_cell({i, j}, (cell_state)symbol);
+                }
+            }
+        }
+    }
+}
+
+int GameGrid::get_nr_draw_calls() {
+    return nr_draw_calls;
+}
@@ -1,23 +1,63 @@
 #include <vector>
 #include <iostream>
 #include <cstdlib>
+#include <algorithm>
 
 #include "custom/game_logic.h"
 #include "custom/game_interface.h"
 #include "custom/utils.h"
 #include "custom/player.h"
+#include "custom/logger.h"
+
+// pseudo random generator used for zobrist keys (fixed seed, so hashes are reproducible)
+static unsigned long long SplitMix64(unsigned long long& state) {
+    unsigned long long z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// image of (row, col) by a symmetry of a nr_rows x nr_columns grid
+// (4 - 7 swap rows and columns, so they only exist for square grids)
+static cell_pos SymmetryImage(cell_pos pos, int symmetry, int nr_rows, int nr_columns) {
+    int r = pos.row;
+    int c = pos.column;
+    int last_row = nr_rows - 1;
+    int last_col = nr_columns - 1;
+
+    switch (symmetry) {
+        case 1: return {r, last_col - c}; // mirror left - right
+        case 2: return {last_row - r, c}; // mirror up - down
+        case 3: return {last_row - r, last_col - c}; // rotation by 180
+        case 4: return {c, r}; // main diagonal
+        case 5: return {c, last_row - r}; // rotation by 90 clockwise
+        case 6: return {last_col - c, r}; // rotation by 90 counterclockwise
+        case 7: return {last_col - c, last_row - r}; // anti diagonal
+        default: return pos;
+    }
+}
 
 GameLogic::GameLogic(int n_rows, int n_cols, int n_win_line)
     : nr_rows(n_rows), nr_columns(n_cols), nr_win_line(n_win_line) {
 
-    game_data.resize(nr_rows);
+    if (nr_win_line > std::min(nr_columns, nr_rows)) {
+        LOG_ERROR("Invalid game logic, nr cells necesary for win is too big\n");
+    }
+
+    row_stride = nr_columns + 1;
+    for (int i = 0; i < 3; i++) {
+        symbol_boards[i].resize(nr_rows * row_stride);
+    }
+    valid_cells.resize(nr_rows * row_stride);
     for (int i = 0; i < nr_rows; i++) {
-        game_data[i].resize(nr_columns);
+        for (int j = 0; j < nr_columns; j++) {
+            valid_cells.set(cell_index({i, j}));
+        }
     }
-    clear_game_data();
 
-    cur_pos = {0, 0};
-    nr_used_cells = 0;
+    build_tables();
+    window_counts.assign(tables->windows.size(), {{0, 0, 0}, 0});
+    clear_game_data();
 
     win_line_data.start_cell.row = 0;
     win_line_data.start_cell.column = 0;
@@ -27,6 +67,87 @@ GameLogic::GameLogic(int n_rows, int n_cols, int n_win_line)
 
 GameLogic::~GameLogic() {};
 
+void GameLogic::build_tables() {
+    const int row_dirs[4] = {0, 1, 1, 1};
+    const int col_dirs[4] = {1, 0, 1, -1};
+    std::shared_ptr<GameTables> new_tables = std::make_shared<GameTables>();
+    std::vector<int> line; // bit indexes of cells of the current line
+
+    new_tables->cell_windows.assign(nr_rows * row_stride * 4, {0, 0});
+
+    for (int dir = 0; dir < 4; dir++) {
+        int step = row_dirs[dir] * row_stride + col_dirs[dir];
+        new_tables->dir_first_window[dir] = new_tables->windows.size();
+
+        for (int i = 0; i < nr_rows; i++) {
+            for (int j = 0; j < nr_columns; j++) {
+                // a line starts in a cell whose previous cell is outside the grid
+                int prev_row = i - row_dirs[dir];
+                int prev_col = j - col_dirs[dir];
+                if (prev_row >= 0 && prev_row < nr_rows && prev_col >= 0 && prev_col < nr_columns) {
+                    continue;
+                }
+
+                line.clear();
+                for (int r = i, c = j; r < nr_rows && c >= 0 && c < nr_columns;
+                    r += row_dirs[dir], c += col_dirs[dir]) {
+                    line.push_back(cell_index({r, c}));
+                }
+
+                int line_length = line.size();
+                int nr_line_windows = line_length - nr_win_line + 1;
+                if (nr_line_windows <= 0) {
+                    continue; // line too short for a win
+                }
+
+                int line_first_window = new_tables->windows.size();
+                for (int t = 0; t < nr_line_windows; t++) {
+                    new_tables->windows.push_back({line[t], step});
+                }
+
+                // cell at position t belongs to windows starting at t - nr_win_line + 1 .. t
+                for (int t = 0; t < line_length; t++) {
+                    int first = std::max(t - nr_win_line + 1, 0);
+                    int last = std::min(t, nr_line_windows - 1);
+                    new_tables->cell_windows[line[t] * 4 + dir] = {line_first_window + first, last - first + 1};
+                }
+            }
+        }
+    }
+    new_tables->dir_first_window[4] = new_tables->windows.size();
+
+    // 3 keys per cell, one for each symbol
+    unsigned long long seed = 0x5EED;
+    new_tables->zobrist_cells.resize(nr_rows * row_stride * 3);
+    for (unsigned long long& key : new_tables->zobrist_cells) {
+        key = SplitMix64(seed);
+    }
+    for (int i = 0; i < 3; i++) {
+        new_tables->zobrist_turns[i] = SplitMix64(seed);
+    }
+
+    // value of a window held by a single symbol, by nr of cells (each extra cell is worth 8 times more,
+    // a full window is worth as much as one missing a cell, shift is 0 for a line of 1)
+    new_tables->line_values.assign(nr_win_line + 1, 0);
+    for (int count = 1; count <= nr_win_line; count++) {
+        int shift = std::clamp(3 * std::min(count - 1, nr_win_line - 2), 0, MAX_LINE_VALUE_SHIFT);
+        new_tables->line_values[count] = 1LL << shift;
+    }
+
+    new_tables->nr_symmetries = nr_rows == nr_columns ? 8 : 4;
+    new_tables->symmetry_cells.assign(nr_rows * row_stride * MAX_SYMMETRIES, 0);
+    for (int i = 0; i < nr_rows; i++) {
+        for (int j = 0; j < nr_columns; j++) {
+            for (int sym = 0; sym < new_tables->nr_symmetries; sym++) {
+                new_tables->symmetry_cells[cell_index({i, j}) * MAX_SYMMETRIES + sym]
+                    = cell_index(SymmetryImage({i, j}, sym, nr_rows, nr_columns));
+            }
+        }
+    }
+
+    tables = new_tables;
+}
+
 void GameLogic::DEBUG_func() {
     std::cout << "_____\nLOGIC DEBUG:\n";
     std::cout << "NR CELLS: Nr rows: " << nr_rows << " Nr columns: " << nr_columns << "\n";
@@ -34,14 +155,29 @@ void GameLogic::DEBUG_func() {
     std::cout << "CUR POS: (" << cur_pos.row << "," << cur_pos.column << ")\n";
     for (int i = 0; i < nr_rows; i++) {
         for (int j = 0; j < nr_columns; j++) {
-            std::cout << game_data[i][j] << " ";
+            std::cout << get_cell_state({i, j}) << " ";
         }
         std::cout << "\n";
     }
 }
 
+int GameLogic::cell_index(cell_pos pos) {
+    return pos.row * row_stride + pos.column;
+}
+
+cell_pos GameLogic::index_cell(int index) {
+    return {index / row_stride, index % row_stride};
+}
+
 cell_state GameLogic::get_cell_state(cell_pos pos) {
-    return game_data[pos.row][pos.column];
+    int index = cell_index(pos);
+
+    for (int symbol = CELL_X; symbol <= CELL_Z; symbol++) {
+        if (symbol_boards[symbol].test(index)) {
+            return (cell_state)symbol;
+        }
+    }
+    return CELL_EMPTY;
 }
 
 int GameLogic::get_nr_rows() {
@@ -52,20 +188,73 @@ int GameLogic::get_nr_columns() {
     return nr_columns;
 }
 
+int GameLogic::get_nr_win_line() {
+    return nr_win_line;
+}
+
 int GameLogic::get_nr_used_cells() {
     return nr_used_cells;
 }
 
 void GameLogic::set_cell_state(cell_pos pos, cell_state state) {
-    if (game_data[pos.row][pos.column] == CELL_EMPTY &&  state != CELL_EMPTY) {
+    cell_state old_state = get_cell_state(pos);
+    int index = cell_index(pos);
+
+    if (old_state == CELL_EMPTY &&  state != CELL_EMPTY) {
         nr_used_cells++;
+
+        // last empty cell takes the place of the marked one
+        int slot = empty_slots[index];
+        cell_pos last = empty_cells.back();
+        empty_cells[slot] = last;
+        empty_slots[cell_index(last)] = slot;
+        empty_cells.pop_back();
+        empty_slots[index] = -1;
     }
 
-    if (game_data[pos.row][pos.column] != CELL_EMPTY &&  state == CELL_EMPTY) {
+    if (old_state != CELL_EMPTY &&  state == CELL_EMPTY) {
         nr_used_cells--;
+
+        empty_slots[index] = empty_cells.size();
+        empty_cells.push_back(pos);
     }
 
-    game_data[pos.row][pos.column] = state;
+    // remove key of old symbol and add key of new one (in the board and in each of its images)
+    const int* images = &tables->symmetry_cells[index * MAX_SYMMETRIES];
+    int nr_symmetries = tables->nr_symmetries;
+    if (old_state != CELL_EMPTY) {
+        for (int sym = 0; sym < nr_symmetries; sym++) {
+            hashes[sym] ^= tables->zobrist_cells[images[sym] * 3 + old_state];
+        }
+        symbol_boards[old_state].reset(index);
+    }
+    if (state != CELL_EMPTY) {
+        for (int sym = 0; sym < nr_symmetries; sym++) {
+            hashes[sym] ^= tables->zobrist_cells[images[sym] * 3 + state];
+        }
+        symbol_boards[state].set(index);
+    }
+
+    // update counters of every window containing the cell (in the order check_win used to scan them)
+    filled_window = -1;
+    for (int dir = DIR_ROW; dir <= DIR_DIAG2; dir++) {
+        window_range range = tables->cell_windows[index * 4 + dir];
+
+        for (int window = range.first; window < range.first + range.count; window++) {
+            if (old_state != CELL_EMPTY && old_state != state) {
+                remove_window_cell(window, old_state);
+            }
+            if (state == CELL_EMPTY) {
+                continue;
+            }
+            if (old_state != state) {
+                add_window_cell(window, state);
+            }
+            if (filled_window == -1 && window_counts[window].symbols[state] == nr_win_line) {
+                filled_window = window;
+            }
+        }
+    }
 
     cur_pos.row = pos.row;
     cur_pos.column = pos.column;
@@ -73,79 +262,161 @@ void GameLogic::set_cell_state(cell_pos pos, cell_state state) {
 
 std::vector<cell_pos> GameLogic::get_available_cells() {
     std::vector<cell_pos> available_cells;
+    get_available_cells(available_cells);
 
-    for (int i = 0; i < nr_rows; i++) {
-        for (int j = 0; j < nr_columns; j++) {
-            if (get_cell_state({i, j}) == CELL_EMPTY) {
-                available_cells.push_back({i, j});
-            }
+    return available_cells;
+}
+
+void GameLogic::get_available_cells(std::vector<cell_pos>& cells) {
+    cells.clear();
+
+    // empty cells are valid cells not set in any symbol board
+    for (int w = 0; w < valid_cells.get_nr_words(); w++) {
+        unsigned long long empty = valid_cells.get_word(w)
+            & ~(symbol_boards[CELL_X].get_word(w)
+                | symbol_boards[CELL_0].get_word(w)
+                | symbol_boards[CELL_Z].get_word(w));
+
+        while (empty != 0) {
+            cells.push_back(index_cell(w * 64 + __builtin_ctzll(empty)));
+            empty &= empty - 1; // drop lowest set bit
         }
     }
+}
 
-    return available_cells;
+const std::vector<cell_pos>& GameLogic::get_empty_cells() {
+    return empty_cells;
+}
+
+cell_pos GameLogic::get_random_empty_cell(std::mt19937& rng) {
+    std::uniform_int_distribution<int> slot(0, (int)empty_cells.size() - 1);
+    return empty_cells[slot(rng)];
+}
+
+unsigned long long GameLogic::get_hash() {
+    return hashes[0];
+}
+
+unsigned long long GameLogic::get_turn_key(int player_index) {
+    return tables->zobrist_turns[player_index];
+}
+
+int GameLogic::get_nr_symmetries() {
+    return tables->nr_symmetries;
 }
 
-bool GameLogic::check_group(cell_state target_state, cell_pos& start, int row_dir, int col_dir) {
-    cell_state cur_cell_state;
-    int cur_row;
-    int cur_col;
-
-    for (int i = 0; i < nr_win_line; i++) {
-        cur_row = start.row + i * row_dir;
-        cur_col = start.column + i * col_dir;
-        cur_cell_state = game_data[cur_row][cur_col];
-        if (cur_cell_state != target_state) {
-            // we should start from next cell now
-            start.row = cur_row + row_dir;
-            start.column = cur_col + col_dir;
-            return false;
+unsigned long long GameLogic::get_canonical_hash(int& symmetry) {
+    symmetry = 0;
+
+    for (int sym = 1; sym < tables->nr_symmetries; sym++) {
+        if (hashes[sym] < hashes[symmetry]) {
+            symmetry = sym;
         }
     }
 
-    return true;
+    return hashes[symmetry];
 }
 
-bool GameLogic::check_win_row(cell_pos pos) {
-    // we verify all "nr_win_line" sized groups that contain current cell
-    // we find first and last possible groups
-    int group_first_col = std::max(pos.column - nr_win_line + 1, 0); // col of first member in first group
-    cell_pos group_first = {pos.row, group_first_col};
-    cell_state target_state = game_data[pos.row][pos.column];
+bool GameLogic::is_symmetric(int symmetry) {
+    return hashes[symmetry] == hashes[0];
+}
 
-    if (target_state == CELL_EMPTY) {
-        return false;
+cell_pos GameLogic::transform_cell(cell_pos pos, int symmetry) {
+    return SymmetryImage(pos, symmetry, nr_rows, nr_columns);
+}
+
+int GameLogic::inverse_symmetry(int symmetry) {
+    // rotations by 90 undo each other, every other symmetry is its own inverse
+    if (symmetry == 5) {
+        return 6;
+    }
+    if (symmetry == 6) {
+        return 5;
     }
+    return symmetry;
+}
 
-    // check bounds and go trough each group
-    while (group_first.column + nr_win_line - 1 < nr_columns) {
-        if (check_group(target_state, group_first, 0, 1) == true) {
-            win_line_data = {group_first, // start cell for win line
-                {group_first.row, group_first.column + nr_win_line - 1} // stop cell for win line
-            };
-            return true;
+int GameLogic::get_nr_windows() {
+    return tables->windows.size();
+}
+
+window_range GameLogic::get_cell_windows(cell_pos pos, win_direction dir) {
+    return tables->cell_windows[cell_index(pos) * 4 + dir];
+}
+
+int GameLogic::get_window_count(int window, cell_state symbol) {
+    return window_counts[window].symbols[symbol];
+}
+
+long long GameLogic::get_line_score(cell_state symbol) {
+    return line_scores[symbol];
+}
+
+// only the changed symbol and a single other owner of the window can change their line score
+void GameLogic::add_window_cell(int window, cell_state symbol) {
+    window_count& counts = window_counts[window];
+    const long long* values = tables->line_values.data();
+    int count = counts.symbols[symbol]++;
+    int nr_other = counts.nr_used++ - count;
+
+    if (nr_other == 0) {
+        line_scores[symbol] += values[count + 1] - values[count];
+    } else if (count == 0) {
+        // window of a single other symbol is now blocked
+        for (int other = CELL_X; other <= CELL_Z; other++) {
+            if (other != symbol && counts.symbols[other] == nr_other) {
+                line_scores[other] -= values[nr_other];
+            }
         }
     }
+}
 
-    return false;
+void GameLogic::remove_window_cell(int window, cell_state symbol) {
+    window_count& counts = window_counts[window];
+    const long long* values = tables->line_values.data();
+    int count = counts.symbols[symbol]--;
+    int nr_other = counts.nr_used-- - count;
+
+    if (nr_other == 0) {
+        line_scores[symbol] += values[count - 1] - values[count];
+    } else if (count == 1) {
+        // window is left to a single other symbol again
+        for (int other = CELL_X; other <= CELL_Z; other++) {
+            if (counts.symbols[other] == nr_other) {
+                line_scores[other] += values[nr_other];
+            }
+        }
+    }
 }
 
-bool GameLogic::check_win_column(cell_pos pos) {
-    // we verify all "nr_win_line" sized groups that contain current cell
-    // we find first and last possible groups
-    int group_first_row = std::max(pos.row - nr_win_line + 1, 0); // row of first member in first group
-    cell_pos group_first = {group_first_row, pos.column};
-    cell_state target_state = game_data[pos.row][pos.column];
+bool GameLogic::check_window(int window, cell_state symbol) {
+    return window_counts[window].symbols[symbol] == nr_win_line;
+}
+
+void GameLogic::set_win_line(int window) {
+    const win_window& group = tables->windows[window];
+    cell_pos first = index_cell(group.start);
+    cell_pos last = index_cell(group.start + (nr_win_line - 1) * group.step);
+
+    if (window >= tables->dir_first_window[DIR_DIAG2]) {
+        win_line_data = {last, first};
+    } else {
+        win_line_data = {first, last};
+    }
+}
+
+bool GameLogic::check_win_direction(cell_pos pos, win_direction dir) {
+    cell_state target_state = get_cell_state(pos);
 
     if (target_state == CELL_EMPTY) {
         return false;
     }
 
-    // check bounds and go trough each group
-    while (group_first.row + nr_win_line - 1 < nr_rows) {
-        if (check_group(target_state, group_first, 1, 0) == true) {
-            win_line_data = {group_first, // start cell for win line
-                {group_first.row + nr_win_line - 1, group_first.column} // stop cell for win line
-            };
+    window_range range = tables->cell_windows[cell_index(pos) * 4 + dir];
+
+    for (int window = range.first; window < range.first + range.count; window++) {
+        if (check_window(window, target_state) == true) {
+            set_win_line(window);
             return true;
         }
     }
@@ -153,78 +424,37 @@ bool GameLogic::check_win_column(cell_pos pos) {
     return false;
 }
 
-bool GameLogic::check_win_diag1(cell_pos pos) {
-    // we verify all "nr_win_line" sized groups that contain current cell
-    // we find first and last possible groups
-    int max_row_offset = pos.row - std::max(pos.row - nr_win_line + 1, 0);
-    int max_col_offset = pos.column - std::max(pos.column - nr_win_line + 1, 0);
-    int offset = std::min(max_row_offset, max_col_offset);
-    
-    int group_first_row = pos.row - offset;
-    int group_first_col = pos.column - offset;
-    cell_pos group_first = {group_first_row, group_first_col};
-    cell_state target_state = game_data[pos.row][pos.column];
-
-    // check bounds and go trough each group
-    while (group_first.row + nr_win_line - 1 < nr_rows
-        && group_first.column + nr_win_line - 1 < nr_columns) {
-
-        if (check_group(target_state, group_first, 1, 1) == true) {
-            win_line_data = {group_first, // start cell for win line
-                {group_first.row + nr_win_line - 1, group_first.column + nr_win_line - 1}
-            };
-            return true;
-        }
-    }
+bool GameLogic::check_win_row(cell_pos pos) {
+    return check_win_direction(pos, DIR_ROW);
+}
 
-    return false;
+bool GameLogic::check_win_column(cell_pos pos) {
+    return check_win_direction(pos, DIR_COLUMN);
 }
 
-bool GameLogic::check_win_diag2(cell_pos pos) {
-    // we verify all "nr_win_line" sized groups that contain current cell
-    // we find first and last possible groups
-    int max_row_offset = std::min(pos.row + nr_win_line - 1, nr_rows - 1) - pos.row;
-    int max_col_offset = pos.column - std::max(pos.column - nr_win_line + 1, 0);
-    int offset = std::min(max_row_offset, max_col_offset);
-    
-    int group_first_row = pos.row + offset;
-    int group_first_col = pos.column - offset;
-    cell_pos group_first = {group_first_row, group_first_col};
-    cell_state target_state = game_data[pos.row][pos.column];
-
-    // check bounds and go trough each group
-    while (group_first.row - nr_win_line + 1 >= 0
-        && group_first.column + nr_win_line - 1 < nr_columns) {
-
-        if (check_group(target_state, group_first, -1, 1) == true) {
-            win_line_data = {group_first, // start cell for win line
-                {group_first.row - nr_win_line + 1, group_first.column + nr_win_line - 1}
-            };
-            return true;
-        }
-    }
+bool GameLogic::check_win_diag1(cell_pos pos) {
+    return check_win_direction(pos, DIR_DIAG1);
+}
 
-    return false;
+bool GameLogic::check_win_diag2(cell_pos pos) {
+    return check_win_direction(pos, DIR_DIAG2);
 }
 
 bool GameLogic::check_win() {
-    // DEBUG
-    std::cout << "_____\nWIN COND DEBUG:\n";
-    std::cout << "ROW WIN: " << check_win_row(cur_pos)
-            << "| COL WIN: " << check_win_column(cur_pos) 
-            << "| DIAG1_WIN: " << check_win_diag1(cur_pos)
-            << "| DIAG2_WIN: " << check_win_diag2(cur_pos) << "\n";
-    
-
-    if (nr_win_line > std::min(nr_columns, nr_rows)) {
-        std::cerr << "Invalid game logic, nr cells necesary for win is too big\n"; 
+    // called for every search node, so this dump only exists in trace builds
+    LOG_TRACE("_____\nWIN COND DEBUG:\n"
+        << "ROW WIN: " << check_win_row(cur_pos)
+        << "| COL WIN: " << check_win_column(cur_pos)
+        << "| DIAG1_WIN: " << check_win_diag1(cur_pos)
+        << "| DIAG2_WIN: " << check_win_diag2(cur_pos) << "\n");
+
+    // set_cell_state already found the first window the last move filled (-1 after any other change)
+    if (filled_window == -1) {
+        return false;
     }
 
-    // check all possibilities of win
-    return check_win_row(cur_pos) 
-        || check_win_column(cur_pos)
-        || check_win_diag1(cur_pos)
-        || check_win_diag2(cur_pos);
+    set_win_line(filled_window);
+    return true;
 }
 
 grid_line_data GameLogic::get_win_line_data() {
@@ -232,17 +462,37 @@ grid_line_data GameLogic::get_win_line_data() {
 }
 
 void GameLogic::clear_game_data() {
+    for (int i = 0; i < 3; i++) {
+        symbol_boards[i].clear();
+    }
+
+    cur_pos = {0, 0};
+    nr_used_cells = 0;
+    for (int sym = 0; sym < MAX_SYMMETRIES; sym++) {
+        hashes[sym] = 0;
+    }
+
+    std::fill(window_counts.begin(), window_counts.end(), window_count{{0, 0, 0}, 0});
+    filled_window = -1;
+
+    // every valid cell is empty again
+    empty_cells.clear();
+    empty_slots.assign(nr_rows * row_stride, -1);
     for (int i = 0; i < nr_rows; i++) {
         for (int j = 0; j < nr_columns; j++) {
-            game_data[i][j] = CELL_EMPTY;
+            empty_slots[cell_index({i, j})] = empty_cells.size();
+            empty_cells.push_back({i, j});
         }
     }
+    for (int symbol = CELL_X; symbol <= CELL_Z; symbol++) {
+        line_scores[symbol] = 0;
+    }
 }
 
 void GameManager::add_player(player_type type, cell_state symbol, robot_difficulty diff) {
     // make sure a player is assigned a proper symbol
     if (symbol == CELL_EMPTY) {
-        std::cerr << "Invalid symbol assignation for player's cells state" << "\n";
+        LOG_ERROR("Invalid symbol assignation for player's cells state" << "\n");
         return;
     }
 
@@ -250,7 +500,12 @@ void GameManager::add_player(player_type type, cell_state symbol, robot_difficul
 
     switch (type) {
         case HUMAN: players.push_back(new Human(symbol, game_logic, game_grid)); break;
-        case ROBOT: players.push_back(new Robot(symbol, game_logic, game_grid, diff, symbols_order)); break;
+        case ROBOT: {
+            Robot* robot = new Robot(symbol, game_logic, game_grid, diff, symbols_order, game_modifiers);
+            robot->set_result_event(robot_event_type);
+            players.push_back(robot);
+            break;
+        }
         default: break;
     }
 
@@ -274,17 +529,36 @@ GameManager::GameManager() {
         game_modifiers.color_Z,
         game_modifiers.color_win
     );
+    // grid layer is drawn again now that it can include the background
+    game_grid->set_background(game_window->get_background());
+    game_grid->handle_render_reset(false);
 
     nr_players = 0;
     cur_player = 0;
+    frame_dirty = true; // first frame is always drawn
+    nr_frames_rendered = 0;
+    nr_frames_skipped = 0;
+    resize_pending = false;
+    nr_relayouts_skipped = 0;
+
+    // SDL was initialized by the window, so user events can be registered
+    robot_event_type = SDL_RegisterEvents(1);
+    if (robot_event_type == (Uint32)-1) {
+        LOG_ERROR("Could not register robot event, robot moves wait for the idle timeout\n");
+        robot_event_type = 0;
+    }
 
+    srand(time(NULL)); // seeded before robots are created, so nothing they build sees the unseeded state
     add_player(game_modifiers.type1, game_modifiers.symbol1, game_modifiers.diff1);
     add_player(game_modifiers.type2, game_modifiers.symbol2, game_modifiers.diff2);
-
-    srand(time(NULL)); // seed the random generator for potential robot players
 }
 
 GameManager::~GameManager() {
+    // robots still thinking read symbols_order, so they are stopped first
+    for (Player* player_p : players) {
+        player_p->cancel_action();
+    }
+
     delete game_logic; // destructor should be automatically called
     delete game_grid;
     delete game_window;
@@ -300,29 +574,47 @@ void GameManager::change_player_turn() {
 
 bool GameManager::decide_win_or_draw() {
     if (game_logic->check_win() == true) {
-        game_grid->set_winner(game_logic->get_win_line_data());
-        return true;
-        
-        // DEBUG
-        std::cout << "_____\nWIN LINE DRAW DEBUG:\n";
         grid_line_data aux = game_logic->get_win_line_data();
-        std::cout << "(" << aux.start_cell.row << "," << aux.start_cell.column << ") -> ";
-        std::cout << "(" << aux.stop_cell.row << "," << aux.stop_cell.column << ")" << "\n";
+        game_grid->set_winner(aux);
+
+        LOG_DEBUG("_____\nWIN LINE DRAW DEBUG:\n"
+            << "(" << aux.start_cell.row << "," << aux.start_cell.column << ") -> "
+            << "(" << aux.stop_cell.row << "," << aux.stop_cell.column << ")" << "\n");
+        return true;
     }
 
     // check if all cells have been used
     if (game_logic->get_nr_used_cells() >= 
         game_logic->get_nr_rows() * game_logic->get_nr_columns()) {
-        std::cout << "____\nDRAW\n";
+        LOG_INFO("____\nDRAW\n");
         return true;
     }
 
     return false;
 }
 
+void GameManager::reset_game() {
+    for (Player* player_p : players) {
+        player_p->cancel_action();
+    }
+
+    game_logic->clear_game_data();
+    game_grid->clear_grid_data();
+    cur_player = 0;
+    frame_dirty = true;
+}
+
 void GameManager::handle_resize_event() {
     game_window->handle_resize();
     game_grid->update_grid_dim();
+    frame_dirty = true;
+}
+
+void GameManager::apply_pending_resize() {
+    if (resize_pending == true) {
+        resize_pending = false;
+        handle_resize_event(); // window size is read now, so it is the last one of the burst
+    }
 }
 
 void GameManager::DEBUG_func() {
@@ -332,78 +624,154 @@ void GameManager::DEBUG_func() {
     std:: cout << "NEXT PLAYER ORDER MOVE: " << cur_player <<  "\n";
 }
 
-void GameManager::game_loop() {
-    bool run_game = true;
-    int mouseX, mouseY;
+long long GameManager::get_nr_frames_rendered() {
+    return nr_frames_rendered;
+}
 
-    while(run_game) { 
-        while (SDL_PollEvent(&event)) {
-            if (event.type == SDL_QUIT) {
-                run_game = false;
-                break;
+long long GameManager::get_nr_frames_skipped() {
+    return nr_frames_skipped;
+}
+
+long long GameManager::get_nr_relayouts_skipped() {
+    return nr_relayouts_skipped;
+}
+
+void GameManager::handle_event(bool& run_game) {
+    if (event.type == SDL_QUIT) {
+        run_game = false;
+        return;
+    }
+    if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_r) {
+        reset_game(); // start a new game, a robot search in progress is dropped
+    }
+    if (event.type == SDL_MOUSEWHEEL && event.wheel.y != 0) {
+        apply_pending_resize();
+        SDL_Point focus;
+        SDL_GetMouseState(&focus.x, &focus.y); // zoom keeps the cell under the mouse in place
+        game_grid->zoom_camera(focus, event.wheel.direction == SDL_MOUSEWHEEL_FLIPPED ? -event.wheel.y : event.wheel.y);
+        frame_dirty = true;
+    }
+    if (event.type == SDL_MOUSEMOTION && (event.motion.state & (SDL_BUTTON_RMASK | SDL_BUTTON_MMASK)) != 0) {
+        apply_pending_resize();
+        game_grid->pan_camera(event.motion.xrel, event.motion.yrel); // drag with right or middle button
+        frame_dirty = true;
+    }
+    if (event.type == SDL_MOUSEBUTTONDOWN && event.button.button == SDL_BUTTON_LEFT) {
+        apply_pending_resize(); // click is mapped to cells of the current layout
+        // we set mouse position for a potential action
+        game_grid->set_mouse_poz({event.button.x, event.button.y});
+
+        if (players[cur_player]->get_type() == HUMAN) {
+            // make next action and check if it was a succes so we can change turn
+            if (players[cur_player]->do_next_action() == true) {
+                LOG_DEBUG("SUCCES HUMAN ACTON WITH NR: " << cur_player << "\n");
+                change_player_turn();
+                frame_dirty = true;
+            } else {
+                LOG_DEBUG("FAILURE HUMAN ACTION WITH NR: " << cur_player << "\n");
             }
-            if (event.type == SDL_MOUSEBUTTONDOWN) {
-                mouseX = event.button.x;
-                mouseY = event.button.y;
-
-                // we set mouse position for a potential action
-                game_grid->set_mouse_poz({mouseX, mouseY});
-            
-                if (players[cur_player]->get_type() == HUMAN) {
-                    // make next action and check if it was a succes so we can change turn
-                    if (players[cur_player]->do_next_action() == true) {
-                        // DEBUG
-                        std::cout << "SUCCES HUMAN ACTON WITH NR: " << cur_player << "\n";
-                        change_player_turn();
-                    } else {
-                        // DEBUG
-                        std::cout << "FAILURE HUMAN ACTION WITH NR: " << cur_player << "\n";
-                    }
-
-                    DEBUG_func();
-
-                    if (decide_win_or_draw() == true) {
-                        run_game = false;
-                    }
-
-                    // DEBUG
-                    std::cout << "\n" << std::endl;
-                }
+
+            LOG_DEBUG_RUN(DEBUG_func());
+
+            if (decide_win_or_draw() == true) {
+                run_game = false;
             }
-            if (event.type == SDL_WINDOWEVENT) {
-                if (event.window.event == SDL_WINDOWEVENT_RESIZED) {
-                    handle_resize_event();
-                }
+
+            LOG_DEBUG("\n" << std::endl);
+        }
+    }
+    if (event.type == SDL_WINDOWEVENT) {
+        if (event.window.event == SDL_WINDOWEVENT_RESIZED) {
+            // dragging the window border sends many resizes, only the last one is laid out
+            if (resize_pending == true) {
+                nr_relayouts_skipped++;
             }
+            resize_pending = true;
+        }
+        if (event.window.event == SDL_WINDOWEVENT_EXPOSED) {
+            frame_dirty = true; // window content was lost (uncovered or restored)
         }
+    }
+    if (event.type == SDL_RENDER_TARGETS_RESET) {
+        game_grid->handle_render_reset(false); // cached grid layer must be drawn again
+        frame_dirty = true;
+    }
+    if (event.type == SDL_RENDER_DEVICE_RESET) {
+        // every texture was lost, background and sprites are created again
+        resize_pending = false; // layout is rebuilt here
+        game_window->handle_resize();
+        game_window->reload_background();
+        game_grid->set_background(game_window->get_background());
+        game_grid->handle_render_reset(true);
+        frame_dirty = true;
+    }
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+    // debug builds can dump the whole game state at any moment with "d" key
+    if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_d) {
+        DEBUG_func();
+    }
+#endif
+}
 
-        if (run_game == true) { // make sure game was not already won by previous human action
-            if (players[cur_player]->get_type() == ROBOT) {
-                if (players[cur_player]->do_next_action() == true) {
-                    // DEBUG
-                    std::cout << "SUCCES ROBOT ACTON WITH NR: " << cur_player << "\n";
-                    change_player_turn();
-                } else {
-                    // DEBUG
-                    std::cout << "FAILURE ROBOT ACTON WITH NR: " << cur_player << "\n";
-                }
+void GameManager::play_robot_turns(bool& run_game) {
+    // robot thinks on its own thread, do_next_action only succeeds once its move is ready
+    // (the first call starts the search, so a robot playing after a robot starts right away)
+    while (run_game == true && players[cur_player]->get_type() == ROBOT
+        && players[cur_player]->do_next_action() == true) {
+        LOG_DEBUG("SUCCES ROBOT ACTON WITH NR: " << cur_player << "\n");
+        change_player_turn();
+        frame_dirty = true;
 
-                DEBUG_func();
+        LOG_DEBUG_RUN(DEBUG_func());
 
-                if (decide_win_or_draw() == true) {
-                    run_game = false;
-                }
+        if (decide_win_or_draw() == true) {
+            run_game = false;
+        }
 
-                // DEBUG
-                std::cout << "\n" << std::endl;
-            }
+        LOG_DEBUG("\n" << std::endl);
+    }
+}
+
+void GameManager::render_frame() {
+    apply_pending_resize(); // at most one relayout per frame
+    if (frame_dirty == false) {
+        nr_frames_skipped++;
+        return;
+    }
+
+    game_window->prepare_render(game_grid->has_static_layer() == false);
+    game_grid->draw_grid();
+    game_window->render();
+
+    frame_dirty = false;
+    nr_frames_rendered++;
+}
+
+void GameManager::game_loop() {
+    bool run_game = true;
+
+    while (run_game) {
+        play_robot_turns(run_game);
+        render_frame();
+        if (run_game == false) {
+            break; // won by a robot
         }
 
-        game_window->prepare_render();
-        game_grid->draw_grid();
-        game_window->render();
+        // sleep until something happens (input, window events, a robot move being ready)
+        if (SDL_WaitEventTimeout(&event, game_modifiers.idle_timeout) != 0) {
+            do {
+                handle_event(run_game);
+            } while (run_game == true && SDL_PollEvent(&event));
+        }
+    }
 
-        run_game == false ? SDL_Delay(game_modifiers.big_delay) : 
-            SDL_Delay(game_modifiers.small_delay);
+    // window closed or game ended, a robot may still be thinking
+    for (Player* player_p : players) {
+        player_p->cancel_action();
     }
-}
\ No newline at end of file
+
+    render_frame(); // last move of the game
+    LOG_INFO("Frames rendered: " << nr_frames_rendered << ", skipped: " << nr_frames_skipped
+        << ", relayouts skipped: " << nr_relayouts_skipped << "\n");
+    SDL_Delay(game_modifiers.big_delay);
+}
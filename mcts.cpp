@@ -0,0 +1,220 @@
+#include "custom/utils.h"
+#include "custom/game_logic.h"
+#include "custom/mcts.h"
+
+MctsEngine::MctsEngine(cell_state s, const GameLogic& position, std::vector<cell_state>& symb_order,
+    GameModifiers& game_modifiers, std::atomic<bool>& cancel, unsigned int seed)
+    : used_symbol(s), symbols_order(symb_order), modifiers(game_modifiers), cancel_requested(cancel),
+    search_logic(position), rng(seed), pool(std::max(1, game_modifiers.mcts_pool_nodes)),
+    nr_used_nodes(0), root_player(0), nr_playouts(0), search_time_ms(0) {};
+
+long long MctsEngine::get_nr_playouts() {
+    return nr_playouts;
+}
+
+double MctsEngine::get_playouts_per_second() {
+    if (search_time_ms <= 0) {
+        return 0;
+    }
+    return nr_playouts * 1000.0 / search_time_ms;
+}
+
+int MctsEngine::get_nr_used_nodes() {
+    return nr_used_nodes;
+}
+
+void MctsEngine::play_cell(int cell, int player) {
+    int nr_columns = search_logic.get_nr_columns();
+    search_logic.set_cell_state({cell / nr_columns, cell % nr_columns}, symbols_order[player]);
+    played_cells.push_back(cell);
+}
+
+void MctsEngine::revert_played_cells() {
+    int nr_columns = search_logic.get_nr_columns();
+
+    for (int cell : played_cells) {
+        search_logic.set_cell_state({cell / nr_columns, cell % nr_columns}, CELL_EMPTY);
+    }
+    played_cells.clear();
+}
+
+int MctsEngine::select_child(int node) {
+    mcts_node& parent = pool[node];
+    float log_visits = std::log((float)parent.nr_visits);
+    int best_child = parent.first_child;
+    float best_value = -1;
+
+    for (int child = parent.first_child; child < parent.first_child + parent.nr_children; child++) {
+        mcts_node& candidate = pool[child];
+        if (candidate.nr_visits == 0) {
+            return child; // every move is tried once before any is tried twice
+        }
+
+        float value = candidate.total_reward / candidate.nr_visits
+            + MCTS_EXPLORATION * std::sqrt(log_visits / candidate.nr_visits);
+        if (value > best_value) {
+            best_value = value;
+            best_child = child;
+        }
+    }
+
+    return best_child;
+}
+
+void MctsEngine::expand(int node) {
+    const std::vector<cell_pos>& free_cells = search_logic.get_empty_cells();
+    int nr_free_cells = free_cells.size();
+    int nr_columns = search_logic.get_nr_columns();
+
+    if (nr_used_nodes + nr_free_cells > (int)pool.size()) {
+        return; // pool is full, node stays a leaf
+    }
+
+    pool[node].first_child = nr_used_nodes;
+    pool[node].nr_children = nr_free_cells;
+    for (cell_pos pos : free_cells) {
+        pool[nr_used_nodes++] = {-1, 0, pos.row * nr_columns + pos.column, 0, 0};
+    }
+}
+
+int MctsEngine::random_playout(int player) {
+    int nr_players = symbols_order.size();
+    int nr_columns = search_logic.get_nr_columns();
+
+    while (search_logic.get_empty_cells().empty() == false) {
+        cell_pos pos = search_logic.get_random_empty_cell(rng);
+        play_cell(pos.row * nr_columns + pos.column, player);
+
+        if (search_logic.check_win()) {
+            return player;
+        }
+        player = (player + 1) % nr_players;
+    }
+
+    return -1; // draw
+}
+
+void MctsEngine::run_iteration() {
+    int nr_players = symbols_order.size();
+
+    // every iteration starts from the searched position (played cells of the last one were reverted)
+    path.clear();
+    path.push_back(0);
+
+    int node = 0;
+    int player = root_player;
+    int winner = -1;
+    bool finished = false;
+
+    // selection (a node whose move ends the game is never expanded)
+    while (pool[node].first_child != -1 && finished == false) {
+        node = select_child(node);
+        path.push_back(node);
+        play_cell(pool[node].move, player);
+
+        if (search_logic.check_win()) {
+            winner = player;
+            finished = true;
+        } else if (search_logic.get_empty_cells().empty()) {
+            finished = true;
+        }
+        player = (player + 1) % nr_players;
+    }
+
+    // expansion of a leaf already visited once, then playout from its first child
+    if (finished == false && (pool[node].nr_visits > 0 || node == 0)) {
+        expand(node);
+
+        if (pool[node].first_child != -1) {
+            node = select_child(node);
+            path.push_back(node);
+            play_cell(pool[node].move, player);
+
+            if (search_logic.check_win()) {
+                winner = player;
+                finished = true;
+            }
+            player = (player + 1) % nr_players;
+        }
+    }
+
+    if (finished == false) {
+        winner = random_playout(player);
+    }
+    revert_played_cells();
+
+    // backpropagation, the move of path[i] was played by player root_player + i - 1
+    pool[0].nr_visits++;
+    for (int i = 1; i < (int)path.size(); i++) {
+        mcts_node& visited = pool[path[i]];
+        int mover = (root_player + i - 1) % nr_players;
+
+        visited.nr_visits++;
+        if (winner == -1) {
+            visited.total_reward += 0.5f;
+        } else if (winner == mover) {
+            visited.total_reward += 1;
+        }
+    }
+}
+
+cell_pos MctsEngine::search(const GameLogic& position) {
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + std::chrono::milliseconds(modifiers.robot_time_budget);
+
+    search_logic = position;
+    int nr_columns = search_logic.get_nr_columns();
+
+    for (int i = 0; i < (int)symbols_order.size(); i++) {
+        if (symbols_order[i] == used_symbol) {
+            root_player = i;
+            break;
+        }
+    }
+
+    // buffers only grow, so a robot allocates them during its first search
+    int nr_root_cells = search_logic.get_empty_cells().size();
+    path.reserve(nr_root_cells + 1);
+    played_cells.reserve(nr_root_cells);
+
+    pool[0] = {-1, 0, -1, 0, 0};
+    nr_used_nodes = 1;
+    nr_playouts = 0;
+
+    while (cancel_requested.load(std::memory_order_relaxed) == false) {
+        if (modifiers.mcts_playouts > 0) {
+            if (nr_playouts >= modifiers.mcts_playouts) {
+                break;
+            }
+        } else if ((nr_playouts & 63) == 0 && std::chrono::steady_clock::now() >= deadline) {
+            break; // clock is only read every 64 playouts
+        }
+
+        run_iteration();
+        nr_playouts++;
+    }
+
+    // most visited move is the most reliable one (first cell in row order on ties, like the other robots,
+    // children are in the order of the empty cells set so the smaller cell index is picked explicitly)
+    int best_move = -1;
+    int best_visits = -1;
+    for (int child = pool[0].first_child; child != -1 && child < pool[0].first_child + pool[0].nr_children; child++) {
+        if (pool[child].nr_visits > best_visits
+            || (pool[child].nr_visits == best_visits && pool[child].move < best_move)) {
+            best_visits = pool[child].nr_visits;
+            best_move = pool[child].move;
+        }
+    }
+    // root was never expanded (search cancelled before any playout), first empty cell in row order
+    if (best_move == -1) {
+        for (cell_pos pos : search_logic.get_empty_cells()) {
+            int move = pos.row * nr_columns + pos.column;
+            if (best_move == -1 || move < best_move) {
+                best_move = move;
+            }
+        }
+    }
+
+    search_time_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return {best_move / nr_columns, best_move % nr_columns};
+}
@@ -0,0 +1,138 @@
+#include "custom/utils.h"
+#include "custom/game_logic.h"
+#include "custom/perfect_play.h"
+
+// positions are stored from the view of the player to move: each cell is a base 3 digit
+// (0 empty, 1 mover, 2 opponent), cell (row, column) is digit row * 3 + column
+const int CLASSIC_CELLS = 9;
+const int CLASSIC_POSITIONS = 19683; // 3 ^ 9
+
+struct perfect_entry {
+    signed char value; // 1 mover wins, 0 draw, -1 mover loses (with perfect play from both sides)
+    signed char move;  // first cell in row order with the best value, -1 if the game is over
+};
+
+struct perfect_table {
+    perfect_entry entries[CLASSIC_POSITIONS];
+};
+
+constexpr int CLASSIC_LINES[8][3] = {
+    {0, 1, 2}, {3, 4, 5}, {6, 7, 8}, // rows
+    {0, 3, 6}, {1, 4, 7}, {2, 5, 8}, // columns
+    {0, 4, 8}, {2, 4, 6}             // diagonals
+};
+
+constexpr int POWERS_3[CLASSIC_CELLS] = {1, 3, 9, 27, 81, 243, 729, 2187, 6561};
+
+constexpr int classic_digit(int position, int cell) {
+    return position / POWERS_3[cell] % 3;
+}
+
+constexpr bool classic_has_line(int position, int digit) {
+    for (const auto& line : CLASSIC_LINES) {
+        if (classic_digit(position, line[0]) == digit && classic_digit(position, line[1]) == digit
+            && classic_digit(position, line[2]) == digit) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// same position seen by the other player (mover and opponent digits swapped)
+constexpr int classic_swap_sides(int position) {
+    int swapped = 0;
+
+    for (int cell = 0; cell < CLASSIC_CELLS; cell++) {
+        int digit = classic_digit(position, cell);
+        swapped += (digit == 0 ? 0 : 3 - digit) * POWERS_3[cell];
+    }
+    return swapped;
+}
+
+constexpr int classic_nr_filled(int position) {
+    int nr_filled = 0;
+
+    for (int cell = 0; cell < CLASSIC_CELLS; cell++) {
+        nr_filled += classic_digit(position, cell) != 0;
+    }
+    return nr_filled;
+}
+
+// negamax over every position, fullest positions first so children are always known
+// (a child is the position after a move, seen by the next player)
+constexpr perfect_table build_perfect_table() {
+    perfect_table table = {};
+
+    for (int nr_filled = CLASSIC_CELLS; nr_filled >= 0; nr_filled--) {
+        for (int position = 0; position < CLASSIC_POSITIONS; position++) {
+            if (classic_nr_filled(position) != nr_filled) {
+                continue;
+            }
+
+            // last move was made by the opponent, so only he can have a line
+            if (classic_has_line(position, 2) == true) {
+                table.entries[position] = {-1, -1};
+                continue;
+            }
+            if (nr_filled == CLASSIC_CELLS) {
+                table.entries[position] = {0, -1};
+                continue;
+            }
+
+            int swapped = classic_swap_sides(position);
+            perfect_entry best = {-2, -1};
+            for (int cell = 0; cell < CLASSIC_CELLS; cell++) {
+                if (classic_digit(position, cell) != 0) {
+                    continue;
+                }
+
+                // the move is an opponent cell for the next player
+                int child = swapped + 2 * POWERS_3[cell];
+                int value = -table.entries[child].value;
+                if (value > best.value) {
+                    best = {(signed char)value, (signed char)cell};
+                }
+            }
+            table.entries[position] = best;
+        }
+    }
+
+    return table;
+}
+
+constexpr perfect_table PERFECT_TABLE = build_perfect_table();
+
+// known results of the classic game
+static_assert(PERFECT_TABLE.entries[0].value == 0, "empty grid must be a draw");
+static_assert(PERFECT_TABLE.entries[0].move == 0, "minimax opens in the top left corner");
+static_assert(PERFECT_TABLE.entries[1 + 3].value == 1 && PERFECT_TABLE.entries[1 + 3].move == 2,
+    "mover completes the top row");
+static_assert(PERFECT_TABLE.entries[2 + 2 * 3 + 81].value == 0
+    && PERFECT_TABLE.entries[2 + 2 * 3 + 81].move == 2, "mover blocks the top row");
+static_assert(PERFECT_TABLE.entries[2 * 1 + 2 * 3 + 1 * 9 + 1 * 81].value == 1,
+    "mover completes the anti diagonal");
+
+bool is_classic_game(GameLogic& logic, int nr_players) {
+    return nr_players == 2 && logic.get_nr_rows() == 3 && logic.get_nr_columns() == 3
+        && logic.get_nr_win_line() == 3;
+}
+
+bool perfect_play_move(GameLogic& logic, cell_state mover, cell_pos& pos, int& value) {
+    int position = 0;
+
+    for (int cell = 0; cell < CLASSIC_CELLS; cell++) {
+        cell_state state = logic.get_cell_state({cell / 3, cell % 3});
+        if (state != CELL_EMPTY) {
+            position += (state == mover ? 1 : 2) * POWERS_3[cell];
+        }
+    }
+
+    const perfect_entry& entry = PERFECT_TABLE.entries[position];
+    if (entry.move == -1) {
+        return false;
+    }
+
+    pos = {entry.move / 3, entry.move % 3};
+    value = entry.value;
+    return true;
+}
@@ -2,12 +2,16 @@
 #include "custom/player.h"
 #include "custom/game_logic.h"
 #include "custom/game_interface.h"
+#include "custom/logger.h"
+#include "custom/perfect_play.h"
 
 Player::Player(player_type t, cell_state s, GameLogic* gl, GameGrid* gg)
     : type(t), used_symbol(s), game_logic_p(gl), game_grid_p(gg) {};
 
 Player::~Player() {};
 
+void Player::cancel_action() {};
+
 player_type Player::get_type() {
     return type;
 }
@@ -31,193 +35,353 @@ bool Human::do_next_action() {
     return human_action();
 }
 
-Robot::Robot(cell_state s, GameLogic* gl, GameGrid* gg, 
-    robot_difficulty diff, std::vector<cell_state>& symb_order)
-    : Player(ROBOT, s, gl, gg), difficulty(diff), symbols_order(symb_order) {};
+Robot::Robot(cell_state s, GameLogic* gl, GameGrid* gg, robot_difficulty diff,
+    std::vector<cell_state>& symb_order, GameModifiers& game_modifiers)
+    : Player(ROBOT, s, gl, gg), difficulty(diff), symbols_order(symb_order),
+    modifiers(game_modifiers), search_position(*gl), transposition_table(game_modifiers.tt_size_mb),
+    mcts_engine(nullptr), rng(game_modifiers.robot_seed != 0 ? game_modifiers.robot_seed : std::random_device{}()),
+    nr_nodes(0), nr_tt_hits(0), completed_depth(0), next_root_move(0), best_root_val(INT_MIN),
+    best_root_index(-1), root_depth(0), helpers_round(0), nr_active_helpers(0), nr_busy_helpers(0),
+    helpers_stop(false), searching(false), result_ready(false), cancel_requested(false),
+    result_found(false), result_event_type(0) {
+
+    if (difficulty == HARD) {
+        root_moves.reserve(gl->get_nr_rows() * gl->get_nr_columns());
+
+        int nr_threads = modifiers.robot_threads;
+        if (nr_threads <= 0) {
+            nr_threads = std::max(1, (int)std::thread::hardware_concurrency());
+        }
 
-Robot::~Robot() {};
+        for (int i = 0; i < nr_threads; i++) {
+            engines.push_back(new SearchEngine(s, *gl, symbols_order, modifiers,
+                transposition_table, cancel_requested));
+        }
+    }
+    if (difficulty == MCTS) {
+        // playouts get their own seed drawn from rng, so they change every launch unless robot_seed is set
+        mcts_engine = new MctsEngine(s, *gl, symbols_order, modifiers, cancel_requested, rng());
+    }
+};
 
-void Robot::robot_round_setup() {
-    // prepare used data structures (old one are probably destroyed automatically)
-    available_cells = game_logic_p->get_available_cells();
-    marked_cells = std::vector(available_cells.size(), false);
-    moves_record = std::stack<cell_pos>();
+Robot::~Robot() {
+    cancel_action(); // worker thread must not outlive the robot
 
-    // prepare player order for games simulations by robot
-    for (int i = 0; i < symbols_order.size(); i++) {
-        if (symbols_order[i] == used_symbol) {
-            cur_player = i;
-            break;
-        }
+    for (SearchEngine* engine : engines) {
+        delete engine;
     }
-    nr_players = symbols_order.size();
+    delete mcts_engine;
+};
+
+long long Robot::get_nr_nodes() {
+    return nr_nodes;
 }
 
-bool Robot::easy_robot_action() {
-    int rand_poz;
+long long Robot::get_nr_tt_hits() {
+    return nr_tt_hits;
+}
 
-    if (available_cells.size() == 0) {
-        return false;
-    }
+int Robot::get_completed_depth() {
+    return completed_depth;
+}
 
-    rand_poz = std::rand() % available_cells.size();
+int Robot::get_nr_threads() {
+    return std::max(1, (int)engines.size());
+}
 
-    game_logic_p->set_cell_state({available_cells[rand_poz].row, 
-        available_cells[rand_poz].column}, 
-        used_symbol
-    );
+long long Robot::get_nr_playouts() {
+    return mcts_engine != nullptr ? mcts_engine->get_nr_playouts() : 0;
+}
 
-    game_grid_p->set_cell_state({available_cells[rand_poz].row, 
-        available_cells[rand_poz].column}, 
-        used_symbol
-    );
+double Robot::get_playouts_per_second() {
+    return mcts_engine != nullptr ? mcts_engine->get_playouts_per_second() : 0;
+}
 
-    return true;    
+cell_pos Robot::easy_robot_move() {
+    // empty cells are kept by the position, no scan of the board
+    return search_position.get_random_empty_cell(rng);
 }
 
-bool Robot::hard_robot_action() {
-    cell_pos action_pos = minimax();
+cell_pos Robot::hard_robot_move() {
+    SearchEngine* main_engine = engines[0];
+    std::chrono::steady_clock::time_point no_deadline;
+
+    // classic game is solved at compile time, no search needed
+    cell_pos table_pos;
+    int table_value;
+    if (modifiers.robot_perfect_table == true && is_classic_game(search_position, symbols_order.size())
+        && perfect_play_move(search_position, used_symbol, table_pos, table_value) == true) {
+        completed_depth = 9 - search_position.get_nr_used_cells();
+        return table_pos;
+    }
 
-    if (available_cells.size() == 0) {
-        return false;
+    transposition_table.new_search();
+    for (SearchEngine* engine : engines) {
+        engine->round_setup(search_position);
+    }
+    if (modifiers.robot_search != SEARCH_MINIMAX) {
+        start_helpers(); // every depth of the search reuses the same threads
     }
 
-    game_logic_p->set_cell_state(action_pos, used_symbol);
-    game_grid_p->set_cell_state(action_pos, used_symbol);
+    cell_pos optimal_pos = main_engine->get_move(0);
+    int nr_moves = main_engine->get_nr_moves();
+
+    if (modifiers.robot_search == SEARCH_MINIMAX) {
+        // plain minimax stays on a single thread (it is only kept as a reference)
+        main_engine->start_iteration(nr_moves, false, no_deadline);
+        optimal_pos = main_engine->minimax_move();
+        completed_depth = nr_moves;
+    } else if (modifiers.robot_search == SEARCH_ALPHA_BETA) {
+        for (SearchEngine* engine : engines) {
+            engine->start_iteration(nr_moves, false, no_deadline);
+        }
+        parallel_alpha_beta(nr_moves, optimal_pos);
+        completed_depth = nr_moves;
+    } else {
+        // iterative deepening: one more ply each time, until whole tree is searched or time is up
+        // (first depth is always finished, so there is always a move)
+        std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now()
+            + std::chrono::milliseconds(modifiers.robot_time_budget);
 
-    return true;
-}
+        for (int depth = 1; depth <= nr_moves; depth++) {
+            cell_pos depth_pos;
 
-bool Robot::do_next_action() {
-    // setup for different kinds of robot actions
-    robot_round_setup();
+            for (SearchEngine* engine : engines) {
+                engine->start_iteration(depth, depth > 1, deadline);
+            }
+            if (parallel_alpha_beta(depth, depth_pos) == false) {
+                break; // unfinished depth, keep move of last finished one
+            }
 
-    switch(difficulty) {
-        case EASY: return easy_robot_action();
-        case HARD: return hard_robot_action();
-        default: return false;
+            optimal_pos = depth_pos;
+            completed_depth = depth;
+        }
     }
 
-    return false;
+    stop_helpers();
+    for (SearchEngine* engine : engines) {
+        nr_nodes += engine->get_nr_nodes();
+        nr_tt_hits += engine->get_nr_tt_hits();
+    }
+
+    return optimal_pos;
 }
 
-// helper functions used for higher difficulties robots
+cell_pos Robot::mcts_robot_move() {
+    cell_pos pos = mcts_engine->search(search_position);
 
-void Robot::next_player_turn() {
-    cur_player = (cur_player + 1) % symbols_order.size();
+    LOG_INFO("MCTS: " << mcts_engine->get_nr_playouts() << " playouts ("
+        << (long long)mcts_engine->get_playouts_per_second() << " per second), "
+        << mcts_engine->get_nr_used_nodes() << " tree nodes\n");
+    return pos;
 }
 
-void Robot::last_player_turn() {
-    cur_player = (cur_player - 1 + symbols_order.size()) % symbols_order.size();
-}
+void Robot::search_root_task(SearchEngine* engine, int i) {
+    int index = root_moves[i];
+    int child_alpha;
 
-bool Robot::is_terminal(bool& win_termination) {
-    // check if last player won the game
-    if (game_logic_p->check_win()) {
-        win_termination = true;
-        return true;
+    {
+        std::lock_guard<std::mutex> lock(root_mutex);
+
+        // a cell before the current best must also be searched for ties (scores are integers)
+        child_alpha = best_root_val;
+        if (best_root_index != -1 && index < best_root_index) {
+            child_alpha = best_root_val - 1;
+        }
     }
 
-    // check if all possible moves where made
-    if (available_cells.size() == moves_record.size()) {
-        win_termination == false;
-        return true;
+    int val = engine->search_root_move(index, root_depth, child_alpha);
+    if (engine->is_aborted() == true) {
+        return;
     }
 
-    return false;
+    // another thread may have found a better move meanwhile, so compare with the current best
+    std::lock_guard<std::mutex> lock(root_mutex);
+    if (val > child_alpha && (val > best_root_val || (val == best_root_val && index < best_root_index))) {
+        best_root_val = val;
+        best_root_index = index;
+    }
 }
 
-// call if game is terminal to get score
-int Robot::evaluate_game_state(bool& win_termination) {
-    if (win_termination == false) {
-        return 0; // draw game
+void Robot::root_split_worker(SearchEngine* engine) {
+    int nr_root_moves = root_moves.size();
+
+    for (int i = next_root_move++; i < nr_root_moves; i = next_root_move++) {
+        search_root_task(engine, i);
+        if (engine->is_aborted() == true) {
+            return;
+        }
     }
+}
 
-    // check if cur player was one who made last move (and won essentialy)
-    if (game_logic_p->get_cell_state(moves_record.top()) == used_symbol) {
-        return 1;
+void Robot::start_helpers() {
+    helpers_round = 0;
+    helpers_stop = false;
+    for (int i = 1; i < (int)engines.size(); i++) {
+        helpers.push_back(std::thread(&Robot::helper_loop, this, i));
     }
-    return -1; // one of opponents won
 }
 
-void Robot::simulate_player_action(cell_pos pos) {
-    game_logic_p->set_cell_state(pos, symbols_order[cur_player]);
-    next_player_turn();
+void Robot::stop_helpers() {
+    {
+        std::lock_guard<std::mutex> lock(helpers_mutex);
+        helpers_stop = true;
+    }
+    helpers_wake.notify_all();
 
-    moves_record.push(pos);
+    for (std::thread& helper : helpers) {
+        helper.join();
+    }
+    helpers.clear();
 }
 
-void Robot::revert_action_simulation() {
-    game_logic_p->set_cell_state(moves_record.top(), CELL_EMPTY);
-    last_player_turn();
+void Robot::helper_loop(int engine_index) {
+    int seen_round = 0;
+    std::unique_lock<std::mutex> lock(helpers_mutex);
 
-    moves_record.pop();
-}
+    while (true) {
+        helpers_wake.wait(lock, [&]() { return helpers_stop == true || helpers_round != seen_round; });
+        if (helpers_stop == true) {
+            return;
+        }
+        seen_round = helpers_round;
+        if (engine_index > nr_active_helpers) {
+            continue; // fewer root moves than threads at this depth
+        }
 
-cell_pos Robot::minimax() {
-    cell_pos optimal_pos = available_cells[0];
-    int val = minimax_helper(0, 100, optimal_pos);
+        lock.unlock();
+        root_split_worker(engines[engine_index]);
+        lock.lock();
 
-    return optimal_pos;
+        nr_busy_helpers--;
+        if (nr_busy_helpers == 0) {
+            helpers_done.notify_one();
+        }
+    }
 }
 
-int Robot::minimax_helper(int cur_depth, int max_depth, cell_pos& optimal_pos) {
-    bool win_termination;
-    if (is_terminal(win_termination) == true) {
-        return evaluate_game_state(win_termination);
-    }
-
-    int sz = available_cells.size();
-    if (symbols_order[cur_player] == used_symbol) {
-        // cur player turn (we maximize)
-        int max_val = INT_MIN;
-        int old_max;
-    
-        for (int index = 0; index < sz; index++) {
-            if (marked_cells[index] == false) { // a move can be explored
-                // simulate action with cur pos
-                marked_cells[index] = true;
-                simulate_player_action(available_cells[index]);
-
-                old_max = max_val;
-                max_val = std::max(max_val, minimax_helper(cur_depth + 1, max_depth, optimal_pos));
-            
-                // check if we found a new more optimal solution for actual cur player move with simulations
-                if (cur_depth == 0 && old_max != max_val) {
-                    optimal_pos = available_cells[index];
-                }
-
-                // revert action
-                marked_cells[index] = false;
-                revert_action_simulation();
-            }
+bool Robot::parallel_alpha_beta(int max_depth, cell_pos& optimal_pos) {
+    SearchEngine* main_engine = engines[0];
+
+    main_engine->root_order(root_moves);
+    best_root_val = INT_MIN;
+    best_root_index = -1;
+    root_depth = max_depth;
+
+    // first move (best one of the last search) is searched alone, so other threads start with its value
+    search_root_task(main_engine, 0);
+    if (main_engine->is_aborted() == true) {
+        return false;
+    }
+    next_root_move.store(1);
+
+    // calling thread is the first worker, helpers started by start_helpers join it
+    int nr_helpers = std::min((int)helpers.size(), (int)root_moves.size() - 1);
+    if (nr_helpers > 0) {
+        {
+            std::lock_guard<std::mutex> lock(helpers_mutex);
+            nr_active_helpers = nr_helpers;
+            nr_busy_helpers = nr_helpers;
+            helpers_round++;
         }
+        helpers_wake.notify_all();
+    }
+    root_split_worker(main_engine);
+    if (nr_helpers > 0) {
+        std::unique_lock<std::mutex> lock(helpers_mutex);
+        helpers_done.wait(lock, [&]() { return nr_busy_helpers == 0; });
+    }
 
-        return max_val;
-    } else {
-        // other player turn (we asume he minimize)
-        int min_val = INT_MAX;
-    
-        for (int index = 0; index < sz; index++) {
-            if (marked_cells[index] == false) { // a move can be explored
-                // simulate action with cur pos
-                marked_cells[index] = true;
-                simulate_player_action(available_cells[index]);
-
-                min_val = std::min(min_val, minimax_helper(cur_depth + 1, max_depth, optimal_pos));
-
-                // revert action
-                marked_cells[index] = false;
-                revert_action_simulation();
-            }
+    for (SearchEngine* engine : engines) {
+        if (engine->is_aborted() == true) {
+            return false;
         }
+    }
+
+    optimal_pos = main_engine->get_move(best_root_index);
+    main_engine->store_root(max_depth, best_root_val, best_root_index);
+    return true;
+}
+
+bool Robot::compute_action(cell_pos& pos) {
+    search_position = *game_logic_p; // search works on a private copy of the position
+    return search_action(pos);
+}
 
-        return min_val;
+bool Robot::search_action(cell_pos& pos) {
+    nr_nodes = 0;
+    nr_tt_hits = 0;
+    completed_depth = 0;
+
+    if (search_position.get_nr_used_cells() == search_position.get_nr_rows() * search_position.get_nr_columns()) {
+        return false;
     }
 
-    return 0;
+    switch(difficulty) {
+        case EASY: pos = easy_robot_move(); break;
+        case HARD: pos = hard_robot_move(); break;
+        case MCTS: pos = mcts_robot_move(); break;
+        default: return false;
+    }
+
+    // a cancelled search may have stopped anywhere, its move is not reliable
+    return cancel_requested.load() == false;
+}
+
+void Robot::search_worker() {
+    result_found = search_action(result_pos);
+    result_ready.store(true, std::memory_order_release);
+
+    // wakes up the event loop (SDL_PushEvent may be called from any thread)
+    if (result_event_type != 0) {
+        SDL_Event event;
+        SDL_zero(event);
+        event.type = result_event_type;
+        SDL_PushEvent(&event);
+    }
 }
 
+void Robot::set_result_event(Uint32 event_type) {
+    result_event_type = event_type;
+}
+
+bool Robot::do_next_action() {
+    if (searching == false) {
+        // snapshot is taken here, on the thread that owns the live GameLogic
+        search_position = *game_logic_p;
+        result_ready.store(false);
+        cancel_requested.store(false);
+        searching = true;
+        search_thread = std::thread(&Robot::search_worker, this);
+        return false;
+    }
+
+    if (result_ready.load(std::memory_order_acquire) == false) {
+        return false; // still thinking
+    }
+
+    search_thread.join();
+    searching = false;
 
+    if (result_found == false) {
+        return false;
+    }
 
+    game_logic_p->set_cell_state(result_pos, used_symbol);
+    if (game_grid_p != nullptr) {
+        game_grid_p->set_cell_state(result_pos, used_symbol);
+    }
 
+    return true;
+}
+
+void Robot::cancel_action() {
+    if (search_thread.joinable()) {
+        cancel_requested.store(true);
+        search_thread.join();
+    }
+
+    searching = false;
+    result_ready.store(false);
+    cancel_requested.store(false);
+}
@@ -0,0 +1,150 @@
+#include <SDL2/SDL.h>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+#include "custom/rasterizer.h"
+
+// adds the span [x1, x2] of row y, clipped to dimensions
+static void AddSpan(std::vector<SDL_Rect>& spans, SDL_Rect dimensions, int y, int x1, int x2) {
+    if (y < dimensions.y || y >= dimensions.y + dimensions.h) {
+        return;
+    }
+    x1 = std::max(x1, dimensions.x);
+    x2 = std::min(x2, dimensions.x + dimensions.w - 1);
+    if (x1 <= x2) {
+        spans.push_back({x1, y, x2 - x1 + 1, 1});
+    }
+}
+
+void RasterizeRing(std::vector<SDL_Rect>& spans, SDL_Rect dimensions, int thickness) {
+    SDL_Point center = {dimensions.x + dimensions.w / 2, dimensions.y + dimensions.h / 2};
+    int radius = std::min(dimensions.h, dimensions.w) * 8 / 20; // we let a 10 % offset (/ 2 / 10)
+    int max_deviation = std::max(thickness, 1) - 1; // thickness 0 still draws the circle itself
+
+    // floor(dist) is in [inner_radius, outer_radius] <=> inner_radius^2 <= dist^2 < (outer_radius + 1)^2
+    int inner_radius = std::max(radius - max_deviation, 0);
+    int outer_radius = radius + max_deviation;
+    long long low = 1LL * inner_radius * inner_radius;
+    long long high = 1LL * (outer_radius + 1) * (outer_radius + 1);
+
+    // like the midpoint circle algorithm both edges only move inwards while rows get further
+    // from the center, so every row reuses the edges of the previous one
+    int outer_x = outer_radius; // last column (from center) inside the ring
+    int inner_x = inner_radius; // first column (from center) inside the ring
+    for (int dy = 0; dy <= outer_radius; dy++) {
+        long long dy2 = 1LL * dy * dy;
+        while (outer_x >= 0 && outer_x * (long long)outer_x + dy2 >= high) {
+            outer_x--;
+        }
+        while (inner_x > 0 && (inner_x - 1) * (long long)(inner_x - 1) + dy2 >= low) {
+            inner_x--;
+        }
+        if (inner_x > outer_x) {
+            continue;
+        }
+
+        int rows[2] = {center.y - dy, center.y + dy};
+        for (int i = 0; i < (dy == 0 ? 1 : 2); i++) {
+            if (inner_x == 0) {
+                AddSpan(spans, dimensions, rows[i], center.x - outer_x, center.x + outer_x);
+            } else {
+                AddSpan(spans, dimensions, rows[i], center.x - outer_x, center.x - inner_x);
+                AddSpan(spans, dimensions, rows[i], center.x + inner_x, center.x + outer_x);
+            }
+        }
+    }
+}
+
+// direction and normal of a stroke (both of length 1), half of its width and its length
+struct stroke_frame {
+    double dir_x, dir_y;
+    double normal_x, normal_y;
+    double half_width;
+    double length;
+};
+
+static stroke_frame GetStrokeFrame(SDL_Point start, SDL_Point stop, int thickness) {
+    stroke_frame frame;
+    double dx = stop.x - start.x;
+    double dy = stop.y - start.y;
+
+    frame.length = std::sqrt(dx * dx + dy * dy);
+    // a single point is widened along x, like a vertical line
+    frame.dir_x = frame.length > 0 ? dx / frame.length : 0;
+    frame.dir_y = frame.length > 0 ? dy / frame.length : 1;
+    frame.normal_x = -frame.dir_y;
+    frame.normal_y = frame.dir_x;
+    frame.half_width = std::max(2 * thickness - 1, 1) / 2.0;
+
+    return frame;
+}
+
+// narrows [x_min, x_max] to the x where low <= a * x + b <= high
+static void ClipInterval(double a, double b, double low, double high, double& x_min, double& x_max) {
+    const double eps = 1e-9; // points exactly on an edge are inside
+
+    if (std::abs(a) < eps) {
+        if (b < low - eps || b > high + eps) {
+            x_min = 1;
+            x_max = 0; // empty
+        }
+        return;
+    }
+
+    double x1 = (low - b) / a;
+    double x2 = (high - b) / a;
+    x_min = std::max(x_min, std::min(x1, x2) - eps);
+    x_max = std::min(x_max, std::max(x1, x2) + eps);
+}
+
+void RasterizeStroke(std::vector<SDL_Rect>& spans, SDL_Point start, SDL_Point stop, int thickness) {
+    stroke_frame frame = GetStrokeFrame(start, stop, thickness);
+    SDL_FPoint corners[4];
+    StrokeCorners(corners, start, stop, thickness);
+
+    double y_min = corners[0].y;
+    double y_max = corners[0].y;
+    for (int i = 1; i < 4; i++) {
+        y_min = std::min(y_min, (double)corners[i].y);
+        y_max = std::max(y_max, (double)corners[i].y);
+    }
+
+    // a point p is covered if its coordinates along the line (u) and across it (v) are in range
+    // u = (p - start) * dir in [-0.5, length + 0.5], v = (p - start) * normal in [-half_width, half_width]
+    for (int y = (int)std::ceil(y_min - 1e-9); y <= (int)std::floor(y_max + 1e-9); y++) {
+        double rel_y = y - start.y;
+        double x_min = -1e18;
+        double x_max = 1e18;
+
+        ClipInterval(frame.dir_x, rel_y * frame.dir_y, -0.5, frame.length + 0.5, x_min, x_max);
+        ClipInterval(frame.normal_x, rel_y * frame.normal_y, -frame.half_width, frame.half_width, x_min, x_max);
+
+        int x1 = start.x + (int)std::ceil(x_min);
+        int x2 = start.x + (int)std::floor(x_max);
+        if (x1 <= x2) {
+            spans.push_back({x1, y, x2 - x1 + 1, 1});
+        }
+    }
+}
+
+void StrokeCorners(SDL_FPoint corners[4], SDL_Point start, SDL_Point stop, int thickness) {
+    stroke_frame frame = GetStrokeFrame(start, stop, thickness);
+    double begin = -0.5; // half a pixel is added at both ends, like a line drawn pixel by pixel
+    double end = frame.length + 0.5;
+    double sides[4][2] = {{begin, -frame.half_width}, {begin, frame.half_width},
+        {end, frame.half_width}, {end, -frame.half_width}};
+
+    for (int i = 0; i < 4; i++) {
+        corners[i].x = start.x + frame.dir_x * sides[i][0] + frame.normal_x * sides[i][1];
+        corners[i].y = start.y + frame.dir_y * sides[i][0] + frame.normal_y * sides[i][1];
+    }
+}
+
+int RenderSpans(SDL_Renderer *renderer, const std::vector<SDL_Rect>& spans) {
+    if (spans.empty()) {
+        return 0;
+    }
+    SDL_RenderFillRects(renderer, spans.data(), spans.size());
+    return 1;
+}
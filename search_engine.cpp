@@ -0,0 +1,554 @@
+#include "custom/utils.h"
+#include "custom/game_logic.h"
+#include "custom/search_engine.h"
+
+SearchEngine::SearchEngine(cell_state s, const GameLogic& position, std::vector<cell_state>& symb_order,
+    GameModifiers& game_modifiers, TranspositionTable& tt, std::atomic<bool>& cancel)
+    : used_symbol(s), symbols_order(symb_order), modifiers(game_modifiers), transposition_table(tt),
+    cancel_requested(cancel), search_logic(position), cur_player(0), nr_nodes(0), nr_tt_hits(0),
+    search_aborted(false), time_limited(false) {
+
+    size_t nr_cells = search_logic.get_nr_rows() * search_logic.get_nr_columns();
+
+    available_cells.reserve(nr_cells);
+    marked_cells.reserve(nr_cells);
+    moves_record.reserve(nr_cells);
+    center_order.reserve(nr_cells);
+    // small boards get every ply of a full search, big ones only as many plies as fit in ARENA_PRESIZED_INTS
+    size_t nr_plies = std::min(nr_cells, std::max<size_t>(ARENA_PRESIZED_INTS / std::max<size_t>(nr_cells, 1), 1));
+    search_arena.assign(nr_cells * (nr_plies + 1), 0);
+    order_top = nr_cells;
+};
+
+void SearchEngine::round_setup(const GameLogic& position) {
+    // prepare used data structures (buffers were sized by the constructor, nothing is allocated)
+    search_logic = position;
+    // only the empty cells are copied (no scan of the board), row order is kept for move ordering ties
+    const std::vector<cell_pos>& empty_cells = search_logic.get_empty_cells();
+    available_cells.assign(empty_cells.begin(), empty_cells.end());
+    std::sort(available_cells.begin(), available_cells.end(), [](cell_pos a, cell_pos b) {
+        return a.row < b.row || (a.row == b.row && a.column < b.column);
+    });
+    marked_cells.assign(available_cells.size(), false);
+    moves_record.clear();
+    order_top = search_logic.get_nr_rows() * search_logic.get_nr_columns();
+    nr_nodes = 0;
+    nr_tt_hits = 0;
+
+    // prepare player order for games simulations by robot
+    for (int i = 0; i < (int)symbols_order.size(); i++) {
+        if (symbols_order[i] == used_symbol) {
+            cur_player = i;
+            break;
+        }
+    }
+
+    // center distance does not change during a search, so we sort only once per round
+    // (distances are doubled so they stay integers, ties keep row order)
+    int nr_rows = search_logic.get_nr_rows();
+    int nr_columns = search_logic.get_nr_columns();
+    int* center_dist = search_arena.data();
+
+    center_order.resize(available_cells.size());
+    for (int i = 0; i < (int)available_cells.size(); i++) {
+        int d_row = 2 * available_cells[i].row - (nr_rows - 1);
+        int d_col = 2 * available_cells[i].column - (nr_columns - 1);
+        center_dist[i] = d_row * d_row + d_col * d_col;
+        center_order[i] = i;
+    }
+    std::sort(center_order.begin(), center_order.end(), [&](int a, int b) {
+        return center_dist[a] < center_dist[b] || (center_dist[a] == center_dist[b] && a < b);
+    });
+}
+
+void SearchEngine::start_iteration(int max_depth, bool limited, std::chrono::steady_clock::time_point deadline) {
+    // plies below the root push at most nr cells ints each, arena only grows before a deeper iteration
+    size_t nr_cells = search_logic.get_nr_rows() * search_logic.get_nr_columns();
+    size_t nr_plies = std::min((size_t)std::max(max_depth, 1), nr_cells);
+    if (search_arena.size() < nr_cells * (nr_plies + 1)) {
+        search_arena.resize(nr_cells * (nr_plies + 1), 0);
+    }
+
+    search_aborted = false; // (cancel_requested is also checked by search_should_stop)
+    time_limited = limited;
+    search_deadline = deadline;
+}
+
+int SearchEngine::get_nr_moves() {
+    return available_cells.size();
+}
+
+cell_pos SearchEngine::get_move(int index) {
+    return available_cells[index];
+}
+
+long long SearchEngine::get_nr_nodes() {
+    return nr_nodes;
+}
+
+long long SearchEngine::get_nr_tt_hits() {
+    return nr_tt_hits;
+}
+
+bool SearchEngine::is_aborted() {
+    return search_aborted;
+}
+
+void SearchEngine::next_player_turn() {
+    cur_player = (cur_player + 1) % symbols_order.size();
+}
+
+void SearchEngine::last_player_turn() {
+    cur_player = (cur_player - 1 + symbols_order.size()) % symbols_order.size();
+}
+
+bool SearchEngine::is_terminal(bool& win_termination) {
+    // check if last player won the game
+    if (search_logic.check_win()) {
+        win_termination = true;
+        return true;
+    }
+
+    // check if all possible moves where made
+    if (available_cells.size() == moves_record.size()) {
+        win_termination = false;
+        return true;
+    }
+
+    return false;
+}
+
+// call if game is terminal to get score
+int SearchEngine::evaluate_game_state(bool& win_termination) {
+    if (win_termination == false) {
+        return 0; // draw game
+    }
+
+    // check if cur player was one who made last move (and won essentialy)
+    if (search_logic.get_cell_state(moves_record.back()) == used_symbol) {
+        return WIN_SCORE;
+    }
+    return -WIN_SCORE; // one of opponents won
+}
+
+int SearchEngine::evaluate_heuristic() {
+    // windows still open for a single player are worth more the fuller they are
+    // (robot windows count for, opponent windows against), sums are kept by search_logic
+    long long score = 0;
+
+    for (int symbol = CELL_X; symbol <= CELL_Z; symbol++) {
+        long long line_score = search_logic.get_line_score((cell_state)symbol);
+        score += symbol == used_symbol ? line_score : -line_score;
+    }
+
+    // heuristic must never look like a finished game
+    return std::clamp(score, (long long)-WIN_SCORE + 1, (long long)WIN_SCORE - 1);
+}
+
+bool SearchEngine::search_should_stop() {
+    if (search_aborted == false && cancel_requested.load(std::memory_order_relaxed) == true) {
+        search_aborted = true;
+    }
+
+    // reading the clock is slow compared to a node, so it is only done every 1024 nodes
+    if (search_aborted == false && time_limited == true && (nr_nodes & 1023) == 0
+        && std::chrono::steady_clock::now() >= search_deadline) {
+        search_aborted = true;
+    }
+
+    return search_aborted;
+}
+
+void SearchEngine::simulate_player_action(cell_pos pos) {
+    search_logic.set_cell_state(pos, symbols_order[cur_player]);
+    next_player_turn();
+
+    moves_record.push_back(pos);
+}
+
+void SearchEngine::revert_action_simulation() {
+    search_logic.set_cell_state(moves_record.back(), CELL_EMPTY);
+    last_player_turn();
+
+    moves_record.pop_back();
+}
+
+unsigned long long SearchEngine::position_key(int& symmetry) {
+    unsigned long long board_hash;
+
+    if (modifiers.robot_symmetry == true) {
+        board_hash = search_logic.get_canonical_hash(symmetry);
+    } else {
+        board_hash = search_logic.get_hash();
+        symmetry = 0;
+    }
+
+    return board_hash ^ search_logic.get_turn_key(cur_player);
+}
+
+int SearchEngine::key_move(cell_pos pos, int symmetry) {
+    cell_pos image = search_logic.transform_cell(pos, symmetry);
+    return image.row * search_logic.get_nr_columns() + image.column;
+}
+
+int SearchEngine::board_move(int move, int symmetry) {
+    if (move == -1) {
+        return -1;
+    }
+
+    int nr_columns = search_logic.get_nr_columns();
+    cell_pos pos = search_logic.transform_cell({move / nr_columns, move % nr_columns},
+        search_logic.inverse_symmetry(symmetry));
+    return pos.row * nr_columns + pos.column;
+}
+
+int SearchEngine::remaining_moves() {
+    return available_cells.size() - moves_record.size();
+}
+
+int SearchEngine::cell_line_potential(cell_pos pos) {
+    cell_state mover = symbols_order[cur_player];
+    int score = 0;
+
+    for (int dir = DIR_ROW; dir <= DIR_DIAG2; dir++) {
+        // every window of nr_win_line cells in this direction that contains pos
+        window_range range = search_logic.get_cell_windows(pos, (win_direction)dir);
+
+        for (int window = range.first; window < range.first + range.count; window++) {
+            int nr_own = 0;
+            int nr_other = 0;
+            int nr_other_symbols = 0;
+
+            for (int symbol = CELL_X; symbol <= CELL_Z; symbol++) {
+                int count = search_logic.get_window_count(window, (cell_state)symbol);
+                if (symbol == mover) {
+                    nr_own = count;
+                } else if (count > 0) {
+                    nr_other += count;
+                    nr_other_symbols++;
+                }
+            }
+
+            // a window still open for us is worth more the more we already own in it
+            if (nr_other == 0) {
+                score += 1 + nr_own * nr_own;
+            }
+            // a window owned by a single opponent should be blocked
+            if (nr_own == 0 && nr_other_symbols == 1) {
+                score += nr_other * nr_other;
+            }
+        }
+    }
+
+    return score;
+}
+
+int SearchEngine::order_moves(int* order, int hash_move) {
+    int nr_order = 0;
+
+    if (modifiers.robot_ordering == ORDER_CENTER) {
+        for (int index : center_order) {
+            if (marked_cells[index] == false) {
+                order[nr_order++] = index;
+            }
+        }
+    } else {
+        for (int index = 0; index < (int)available_cells.size(); index++) {
+            if (marked_cells[index] == false) {
+                order[nr_order++] = index;
+            }
+        }
+    }
+
+    if (modifiers.robot_ordering == ORDER_LINE_POTENTIAL) {
+        // ties keep row order (std::sort does not allocate, unlike std::stable_sort)
+        int* potential = search_arena.data();
+        for (int i = 0; i < nr_order; i++) {
+            potential[order[i]] = cell_line_potential(available_cells[order[i]]);
+        }
+        std::sort(order, order + nr_order, [&](int a, int b) {
+            return potential[a] > potential[b] || (potential[a] == potential[b] && a < b);
+        });
+    }
+
+    // best move found last time this position was searched goes first
+    if (hash_move != -1) {
+        int nr_columns = search_logic.get_nr_columns();
+        for (int i = 0; i < nr_order; i++) {
+            cell_pos pos = available_cells[order[i]];
+            if (pos.row * nr_columns + pos.column == hash_move) {
+                std::rotate(order, order + i, order + i + 1);
+                break;
+            }
+        }
+    }
+
+    return nr_order;
+}
+
+cell_pos SearchEngine::minimax_move() {
+    cell_pos optimal_pos = available_cells[0];
+
+    minimax_helper(0, 100, optimal_pos);
+    return optimal_pos;
+}
+
+int SearchEngine::minimax_helper(int cur_depth, int max_depth, cell_pos& optimal_pos) {
+    bool win_termination = false;
+    nr_nodes++;
+    if (is_terminal(win_termination) == true) {
+        return evaluate_game_state(win_termination);
+    }
+
+    if (cur_depth > 0 && search_should_stop() == true) {
+        return 0; // search was cancelled, value is thrown away
+    }
+
+    // position already searched through another order of moves (root still needs its move)
+    tt_entry entry;
+    int symmetry;
+    unsigned long long key = position_key(symmetry);
+    if (cur_depth > 0 && transposition_table.probe(key, entry) == true) {
+        nr_tt_hits++;
+        // (stored depths saturate at TT_MAX_DEPTH, so the needed one is capped the same way)
+        if (entry.bound == TT_EXACT && entry.depth >= std::min(remaining_moves(), TT_MAX_DEPTH)) {
+            return entry.value;
+        }
+    }
+
+    int val = minimax_search(cur_depth, max_depth, optimal_pos);
+    if (search_aborted == false) {
+        transposition_table.store(key, val, remaining_moves(), TT_EXACT, -1);
+    }
+
+    return val;
+}
+
+int SearchEngine::minimax_search(int cur_depth, int max_depth, cell_pos& optimal_pos) {
+    int sz = available_cells.size();
+    if (symbols_order[cur_player] == used_symbol) {
+        // cur player turn (we maximize)
+        int max_val = INT_MIN;
+        int old_max;
+
+        for (int index = 0; index < sz; index++) {
+            if (marked_cells[index] == false) { // a move can be explored
+                // simulate action with cur pos
+                marked_cells[index] = true;
+                simulate_player_action(available_cells[index]);
+
+                old_max = max_val;
+                max_val = std::max(max_val, minimax_helper(cur_depth + 1, max_depth, optimal_pos));
+
+                // check if we found a new more optimal solution for actual cur player move with simulations
+                if (cur_depth == 0 && old_max != max_val) {
+                    optimal_pos = available_cells[index];
+                }
+
+                // revert action
+                marked_cells[index] = false;
+                revert_action_simulation();
+            }
+        }
+
+        return max_val;
+    } else {
+        // other player turn (we asume he minimize)
+        int min_val = INT_MAX;
+
+        for (int index = 0; index < sz; index++) {
+            if (marked_cells[index] == false) { // a move can be explored
+                // simulate action with cur pos
+                marked_cells[index] = true;
+                simulate_player_action(available_cells[index]);
+
+                min_val = std::min(min_val, minimax_helper(cur_depth + 1, max_depth, optimal_pos));
+
+                // revert action
+                marked_cells[index] = false;
+                revert_action_simulation();
+            }
+        }
+
+        return min_val;
+    }
+}
+
+void SearchEngine::root_order(std::vector<int>& order) {
+    tt_entry entry;
+    int symmetry;
+    int hash_move = -1;
+
+    if (transposition_table.probe(position_key(symmetry), entry) == true) {
+        nr_tt_hits++;
+        hash_move = board_move(entry.best_move, symmetry);
+    }
+    order.resize(available_cells.size());
+    order.resize(order_moves(order.data(), hash_move));
+
+    if (modifiers.robot_symmetry == false) {
+        return;
+    }
+
+    // a move mapped to a cell earlier in row order by a symmetry of the board has the same value
+    // as that cell, so only the first cell of each group is searched (the one minimax would pick)
+    int nr_columns = search_logic.get_nr_columns();
+    int board_symmetries[MAX_SYMMETRIES];
+    int nr_board_symmetries = 0;
+    for (int sym = 1; sym < search_logic.get_nr_symmetries(); sym++) {
+        if (search_logic.is_symmetric(sym) == true) {
+            board_symmetries[nr_board_symmetries++] = sym;
+        }
+    }
+
+    // kept moves are compacted at the front of order
+    int nr_unique = 0;
+    for (int index : order) {
+        cell_pos pos = available_cells[index];
+        bool first_of_group = true;
+
+        for (int i = 0; i < nr_board_symmetries; i++) {
+            int sym = board_symmetries[i];
+            cell_pos image = search_logic.transform_cell(pos, sym);
+            if (image.row * nr_columns + image.column < pos.row * nr_columns + pos.column) {
+                first_of_group = false;
+                break;
+            }
+        }
+        if (first_of_group == true) {
+            order[nr_unique++] = index;
+        }
+    }
+    order.resize(nr_unique);
+}
+
+int SearchEngine::search_root_move(int index, int max_depth, int alpha) {
+    marked_cells[index] = true;
+    simulate_player_action(available_cells[index]);
+
+    int val = alpha_beta_helper(1, max_depth, alpha, INT_MAX);
+
+    marked_cells[index] = false;
+    revert_action_simulation();
+
+    return val;
+}
+
+void SearchEngine::store_root(int max_depth, int value, int index) {
+    int symmetry;
+    unsigned long long key = position_key(symmetry);
+
+    transposition_table.store(key, value, std::min(max_depth, remaining_moves()), TT_EXACT,
+        key_move(available_cells[index], symmetry));
+}
+
+int SearchEngine::alpha_beta_helper(int cur_depth, int max_depth, int alpha, int beta) {
+    bool win_termination = false;
+    nr_nodes++;
+    if (is_terminal(win_termination) == true) {
+        return evaluate_game_state(win_termination);
+    }
+
+    if (search_should_stop() == true) {
+        return 0; // value is thrown away with the whole unfinished depth
+    }
+
+    // nr of plies searched below this node (a depth past the last move is a full search)
+    int depth_left = std::min(max_depth - cur_depth, remaining_moves());
+    if (depth_left == 0) {
+        return evaluate_heuristic();
+    }
+
+    tt_entry entry;
+    int symmetry;
+    int hash_move = -1;
+    unsigned long long key = position_key(symmetry);
+    if (transposition_table.probe(key, entry) == true) {
+        nr_tt_hits++;
+        hash_move = board_move(entry.best_move, symmetry);
+
+        // a stored value (or bound) is enough if it already decides this node
+        // (stored depths saturate at TT_MAX_DEPTH, so the needed one is capped the same way)
+        if (entry.depth >= std::min(depth_left, TT_MAX_DEPTH)) {
+            if (entry.bound == TT_EXACT
+                || (entry.bound == TT_LOWER && entry.value >= beta)
+                || (entry.bound == TT_UPPER && entry.value <= alpha)) {
+                return entry.value;
+            }
+        }
+    }
+
+    // move order of this ply lives on the arena stack until the ply is done
+    int* order = &search_arena[order_top];
+    int nr_order = order_moves(order, hash_move);
+    order_top += nr_order;
+
+    int alpha_orig = alpha;
+    int beta_orig = beta;
+    int best_val;
+    int best_index = order[0];
+
+    if (symbols_order[cur_player] == used_symbol) {
+        // cur player turn (we maximize)
+        best_val = INT_MIN;
+
+        for (int i = 0; i < nr_order; i++) {
+            int index = order[i];
+            marked_cells[index] = true;
+            simulate_player_action(available_cells[index]);
+
+            int val = alpha_beta_helper(cur_depth + 1, max_depth, alpha, beta);
+
+            marked_cells[index] = false;
+            revert_action_simulation();
+
+            if (val > best_val) {
+                best_val = val;
+                best_index = index;
+            }
+            alpha = std::max(alpha, best_val);
+            if (alpha >= beta) {
+                break; // min player already has a better option elsewhere
+            }
+        }
+    } else {
+        // other player turn (we asume he minimize)
+        best_val = INT_MAX;
+
+        for (int i = 0; i < nr_order; i++) {
+            int index = order[i];
+            marked_cells[index] = true;
+            simulate_player_action(available_cells[index]);
+
+            int val = alpha_beta_helper(cur_depth + 1, max_depth, alpha, beta);
+
+            marked_cells[index] = false;
+            revert_action_simulation();
+
+            if (val < best_val) {
+                best_val = val;
+                best_index = index;
+            }
+            beta = std::min(beta, best_val);
+            if (alpha >= beta) {
+                break; // max player already has a better option elsewhere
+            }
+        }
+    }
+    order_top -= nr_order;
+
+    if (search_aborted == true) {
+        return 0; // unfinished values must not reach the transposition table
+    }
+
+    // values outside the starting window are only bounds of the real value
+    tt_bound bound = TT_EXACT;
+    if (best_val <= alpha_orig) {
+        bound = TT_UPPER;
+    } else if (best_val >= beta_orig) {
+        bound = TT_LOWER;
+    }
+    transposition_table.store(key, best_val, depth_left, bound, key_move(available_cells[best_index], symmetry));
+
+    return best_val;
+}
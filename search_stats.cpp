@@ -0,0 +1,396 @@
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <thread>
+#include <set>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "custom/utils.h"
+#include "custom/game_logic.h"
+#include "custom/player.h"
+#include "custom/perfect_play.h"
+
+// console tool that compares robot search modes on fixed positions
+// (prints visited nodes and checks that every mode picks the same move,
+// parallel searches are timed on longer positions against the same search on one thread,
+// MCTS robots print their playouts per second, the classic 3x3 table is checked against minimax,
+// single thread searches must not allocate memory)
+
+// every heap allocation of the program goes through here, so searches can count them
+std::atomic<long long> nr_allocations(0);
+
+void* operator new(std::size_t size) {
+    nr_allocations++;
+    void* memory = std::malloc(size > 0 ? size : 1);
+    if (memory == nullptr) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+struct stats_position {
+    const char* name;
+    int nr_rows;
+    int nr_columns;
+    int nr_win_line;
+    const char* cells; // row by row, '.' empty, 'X' and '0' for players
+};
+
+struct stats_config {
+    const char* label;
+    search_mode mode;
+    move_ordering ordering;
+    int tt_size_mb;
+    int threads; // 0 for all cores
+    bool symmetry;
+};
+
+struct stats_result {
+    cell_pos pos;
+    long long nr_nodes;
+    long long nr_tt_hits;
+    int depth;
+    int threads;
+    double time_ms;
+    long long nr_allocations; // heap allocations during the search
+};
+
+// first config is the reference every other one is compared to
+const stats_config configs[] = {
+    {"minimax                            ", SEARCH_MINIMAX, ORDER_NONE, 0, 1, false},
+    {"minimax + tt                       ", SEARCH_MINIMAX, ORDER_NONE, 16, 1, false},
+    {"minimax + tt + symmetry            ", SEARCH_MINIMAX, ORDER_NONE, 16, 1, true},
+    {"alpha-beta (no order)              ", SEARCH_ALPHA_BETA, ORDER_NONE, 0, 1, false},
+    {"alpha-beta (center)                ", SEARCH_ALPHA_BETA, ORDER_CENTER, 0, 1, false},
+    {"alpha-beta (potential)             ", SEARCH_ALPHA_BETA, ORDER_LINE_POTENTIAL, 0, 1, false},
+    {"alpha-beta (potential) + tt        ", SEARCH_ALPHA_BETA, ORDER_LINE_POTENTIAL, 16, 1, false},
+    {"alpha-beta (potential) + tt + sym  ", SEARCH_ALPHA_BETA, ORDER_LINE_POTENTIAL, 16, 1, true},
+    {"alpha-beta (potential) + tt, 2 thr ", SEARCH_ALPHA_BETA, ORDER_LINE_POTENTIAL, 16, 2, false},
+    {"alpha-beta (potential) + tt, all   ", SEARCH_ALPHA_BETA, ORDER_LINE_POTENTIAL, 16, 0, false},
+    {"iterative (potential) + tt         ", SEARCH_ITERATIVE, ORDER_LINE_POTENTIAL, 16, 1, false},
+    {"iterative (potential) + tt + sym   ", SEARCH_ITERATIVE, ORDER_LINE_POTENTIAL, 16, 1, true},
+    {"iterative (potential) + tt, all    ", SEARCH_ITERATIVE, ORDER_LINE_POTENTIAL, 16, 0, false}
+};
+
+// positions are partially filled so plain minimax still ends in reasonable time
+const stats_position positions[] = {
+    {"3x3 empty", 3, 3, 3,
+        "..."
+        "..."
+        "..."},
+    {"4x4 k=3", 4, 4, 3,
+        "X0.."
+        ".X.."
+        "..0."
+        "..X0"},
+    {"4x4 k=4", 4, 4, 4,
+        "X0X0"
+        "0X.."
+        "...."
+        "...."},
+    {"5x5 k=4", 5, 5, 4,
+        "X0X0."
+        "0X0X."
+        "0X0X."
+        "X0..."
+        "....X"}
+};
+
+// parallel speedup needs searches long enough that starting threads does not matter
+// (plain minimax would take too long on them, so only alpha-beta searches are compared)
+const stats_position speedup_positions[] = {
+    {"4x4 k=4 after 1 move", 4, 4, 4,
+        "...."
+        ".X.."
+        "...."
+        "...."},
+    {"5x5 k=4 mid-game", 5, 5, 4,
+        "X0X0."
+        "0X..."
+        "...X0"
+        "....."
+        "....."}
+};
+
+// thread counts every speedup search runs with (0 for all cores), the first one is the reference
+const int speedup_threads[] = {1, 2, 0};
+
+// MCTS robots play boards too big for HARD, they are only checked on a forced win
+struct mcts_position {
+    stats_position position;
+    int win_row; // winning move, -1 if there is none
+    int win_column;
+};
+
+const mcts_position mcts_positions[] = {
+    {{"10x10 k=5 empty", 10, 10, 5,
+        ".........."
+        ".........."
+        ".........."
+        ".........."
+        ".........."
+        ".........."
+        ".........."
+        ".........."
+        ".........."
+        ".........."}, -1, -1},
+    {{"10x10 k=5 win in 1", 10, 10, 5,
+        "0........0"
+        ".........."
+        ".........."
+        ".........."
+        ".0XXXX...."
+        ".........."
+        ".........."
+        ".........."
+        ".........."
+        ".........0"}, 4, 6},
+    {{"15x15 k=5 empty", 15, 15, 5,
+        "..............."
+        "..............."
+        "..............."
+        "..............."
+        "..............."
+        "..............."
+        "..............."
+        "..............."
+        "..............."
+        "..............."
+        "..............."
+        "..............."
+        "..............."
+        "..............."
+        "..............."}, -1, -1}
+};
+
+cell_state load_position(GameLogic& logic, const stats_position& position) {
+    int nr_X = 0;
+    int nr_0 = 0;
+
+    for (int i = 0; i < position.nr_rows; i++) {
+        for (int j = 0; j < position.nr_columns; j++) {
+            char c = position.cells[i * position.nr_columns + j];
+            if (c == 'X') {
+                logic.set_cell_state({i, j}, CELL_X);
+                nr_X++;
+            } else if (c == '0') {
+                logic.set_cell_state({i, j}, CELL_0);
+                nr_0++;
+            }
+        }
+    }
+
+    return nr_X == nr_0 ? CELL_X : CELL_0; // symbol of player to move
+}
+
+stats_result run_search(const stats_position& position, const stats_config& config) {
+    GameModifiers modifiers;
+    GameLogic logic(position.nr_rows, position.nr_columns, position.nr_win_line);
+    std::vector<cell_state> symbols_order = {CELL_X, CELL_0};
+
+    modifiers.robot_search = config.mode;
+    modifiers.robot_ordering = config.ordering;
+    modifiers.tt_size_mb = config.tt_size_mb;
+    modifiers.robot_threads = config.threads;
+    modifiers.robot_symmetry = config.symmetry;
+    modifiers.robot_perfect_table = false; // 3x3 positions must be searched to be compared
+    modifiers.robot_time_budget = 60000; // enough to finish every depth of these positions
+    cell_state to_move = load_position(logic, position);
+    Robot robot(to_move, &logic, nullptr, HARD, symbols_order, modifiers);
+
+    stats_result result;
+    long long allocations_before = nr_allocations.load();
+    auto start = std::chrono::steady_clock::now();
+    robot.compute_action(result.pos);
+    auto stop = std::chrono::steady_clock::now();
+    result.nr_allocations = nr_allocations.load() - allocations_before;
+
+    result.nr_nodes = robot.get_nr_nodes();
+    result.nr_tt_hits = robot.get_nr_tt_hits();
+    result.depth = robot.get_completed_depth();
+    result.threads = robot.get_nr_threads();
+    result.time_ms = std::chrono::duration<double, std::milli>(stop - start).count();
+    return result;
+}
+
+void print_result(const char* label, const stats_result& result, const stats_result& reference) {
+    std::cout << "  " << label
+        << " move: (" << result.pos.row << "," << result.pos.column << ")"
+        << " nodes: " << result.nr_nodes
+        << " ratio: " << 1.0 * reference.nr_nodes / result.nr_nodes
+        << " tt hits: " << result.nr_tt_hits
+        << " depth: " << result.depth
+        << " time: " << result.time_ms << " ms"
+        << " allocs: " << result.nr_allocations;
+    if (result.threads != 1) {
+        std::cout << " threads: " << result.threads;
+    }
+    std::cout << (result.pos.row == reference.pos.row && result.pos.column == reference.pos.column
+            ? "" : "  MISMATCH")
+        << (result.threads == 1 && result.nr_allocations != 0 ? "  ALLOCATED" : "")
+        << "\n";
+}
+
+// times alpha-beta and iterative deepening on every thread count of speedup_threads,
+// returns false if a parallel search picks another move than the single thread one
+bool run_speedups() {
+    bool all_match = true;
+    stats_config speedup_configs[] = {
+        {"alpha-beta (potential) + tt", SEARCH_ALPHA_BETA, ORDER_LINE_POTENTIAL, 16, 1, false},
+        {"iterative (potential) + tt ", SEARCH_ITERATIVE, ORDER_LINE_POTENTIAL, 16, 1, false}
+    };
+
+    // on a single core the threads only take turns, the speedup is then expected to stay near 1
+    std::cout << "parallel speedup (" << std::thread::hardware_concurrency() << " cores):\n";
+    for (const stats_position& position : speedup_positions) {
+        std::cout << position.name << ":\n";
+
+        for (stats_config& config : speedup_configs) {
+            stats_result single_thread{}; // set by the first (single thread) run
+
+            for (int threads : speedup_threads) {
+                config.threads = threads;
+                stats_result result = run_search(position, config);
+                if (threads == speedup_threads[0]) {
+                    single_thread = result;
+                }
+
+                std::cout << "  " << config.label
+                    << " threads: " << result.threads
+                    << " move: (" << result.pos.row << "," << result.pos.column << ")"
+                    << " nodes: " << result.nr_nodes
+                    << " time: " << result.time_ms << " ms"
+                    << " speedup: " << single_thread.time_ms / result.time_ms
+                    << (result.pos.row == single_thread.pos.row && result.pos.column == single_thread.pos.column
+                        ? "" : "  MISMATCH")
+                    << "\n";
+                if (result.pos.row != single_thread.pos.row || result.pos.column != single_thread.pos.column) {
+                    all_match = false;
+                }
+            }
+        }
+    }
+
+    return all_match;
+}
+
+// compares the compile time table with a runtime minimax on every reachable position of
+// the classic game (returns nr of positions with a different move)
+int check_perfect_table(GameLogic& logic, std::vector<cell_state>& symbols_order, int cur_player,
+    std::set<unsigned long long>& visited) {
+
+    if (visited.insert(logic.get_hash()).second == false) {
+        return 0; // already reached through another order of moves
+    }
+
+    cell_pos table_pos;
+    int table_value;
+    cell_state mover = symbols_order[cur_player];
+    if (perfect_play_move(logic, mover, table_pos, table_value) == false) {
+        return 0; // game over
+    }
+
+    GameModifiers modifiers;
+    modifiers.robot_search = SEARCH_MINIMAX;
+    modifiers.robot_perfect_table = false;
+    modifiers.tt_size_mb = 1;
+    Robot robot(mover, &logic, nullptr, HARD, symbols_order, modifiers);
+    cell_pos search_pos;
+    robot.compute_action(search_pos);
+
+    int nr_mismatches = search_pos.row != table_pos.row || search_pos.column != table_pos.column;
+
+    for (cell_pos pos : logic.get_available_cells()) {
+        logic.set_cell_state(pos, mover);
+        if (logic.check_win() == false) {
+            nr_mismatches += check_perfect_table(logic, symbols_order, 1 - cur_player, visited);
+        }
+        logic.set_cell_state(pos, CELL_EMPTY);
+    }
+
+    return nr_mismatches;
+}
+
+// returns false if the robot missed a forced win
+bool run_mcts(const mcts_position& test) {
+    const stats_position& position = test.position;
+    GameModifiers modifiers;
+    GameLogic logic(position.nr_rows, position.nr_columns, position.nr_win_line);
+    std::vector<cell_state> symbols_order = {CELL_X, CELL_0};
+
+    modifiers.mcts_playouts = 20000;
+    cell_state to_move = load_position(logic, position);
+    Robot robot(to_move, &logic, nullptr, MCTS, symbols_order, modifiers);
+
+    cell_pos pos;
+    robot.compute_action(pos);
+    bool found = test.win_row == -1 || (pos.row == test.win_row && pos.column == test.win_column);
+
+    std::cout << "  mcts " << position.name
+        << " move: (" << pos.row << "," << pos.column << ")"
+        << " playouts: " << robot.get_nr_playouts()
+        << " playouts/s: " << (long long)robot.get_playouts_per_second()
+        << (found ? "" : "  MISSED WIN")
+        << "\n";
+    return found;
+}
+
+int main() {
+    bool all_match = true;
+
+    for (const stats_position& position : positions) {
+        std::cout << position.name << ":\n";
+
+        stats_result reference = run_search(position, configs[0]);
+        print_result(configs[0].label, reference, reference);
+        if (reference.nr_allocations != 0) {
+            all_match = false;
+        }
+
+        for (int i = 1; i < (int)(sizeof(configs) / sizeof(configs[0])); i++) {
+            stats_result result = run_search(position, configs[i]);
+            print_result(configs[i].label, result, reference);
+
+            if (result.pos.row != reference.pos.row || result.pos.column != reference.pos.column) {
+                all_match = false;
+            }
+            // helper threads allocate their own state, only single thread searches must be allocation free
+            if (result.threads == 1 && result.nr_allocations != 0) {
+                all_match = false;
+            }
+        }
+    }
+
+    if (run_speedups() == false) {
+        all_match = false;
+    }
+
+    GameLogic classic(3, 3, 3);
+    std::vector<cell_state> classic_order = {CELL_X, CELL_0};
+    std::set<unsigned long long> classic_positions;
+    int nr_table_mismatches = check_perfect_table(classic, classic_order, 0, classic_positions);
+    std::cout << "perfect play table: " << classic_positions.size() << " positions, "
+        << nr_table_mismatches << " different from minimax\n";
+    if (nr_table_mismatches != 0) {
+        all_match = false;
+    }
+
+    std::cout << "mcts:\n";
+    for (const mcts_position& test : mcts_positions) {
+        if (run_mcts(test) == false) {
+            all_match = false;
+        }
+    }
+
+    return all_match ? 0 : 1;
+}
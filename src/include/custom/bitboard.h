@@ -0,0 +1,36 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <vector>
+
+// set of cells stored as bits (cell index = row * row_stride + column)
+// row_stride is nr_columns + 1, so every row ends with an always empty guard bit
+class Bitboard {
+  private:
+    std::vector<unsigned long long> words;
+
+  public:
+    Bitboard();
+    Bitboard(int nr_bits);
+    void resize(int nr_bits);
+    void clear();
+
+    bool test(int index) const {
+        return (words[index >> 6] >> (index & 63)) & 1ULL;
+    }
+    void set(int index) {
+        words[index >> 6] |= 1ULL << (index & 63);
+    }
+    void reset(int index) {
+        words[index >> 6] &= ~(1ULL << (index & 63));
+    }
+
+    int get_nr_words() const {
+        return words.size();
+    }
+    unsigned long long get_word(int word_index) const {
+        return words[word_index];
+    }
+};
+
+#endif
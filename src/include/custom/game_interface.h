@@ -12,24 +12,30 @@ class GameWindow {
     SDL_Window *window;
     SDL_Rect viewport;
     SDL_Renderer *renderer;
-    SDL_Texture *background;
+    SDL_Texture *background; // decoded once, stretched over the viewport when copied
 
   public:
     SDL_Renderer* get_renderer();
     SDL_Window* get_window();
+    SDL_Texture* get_background();
   
     GameWindow();
     // use before updating the rest of visual elements and render
-    void prepare_render();
+    // (draw_background is false when the background is already part of a cached layer)
+    void prepare_render(bool draw_background);
     // use after updating the rest of visual elements and prepare_render
     void render();
     // function that should be used when window was resized
     void handle_resize();
+    // decodes the background again (textures are lost with the render device)
+    void reload_background();
     ~GameWindow();
 };
 
 class GameGrid {
   private:
+    // grid_dim and cell_size are the camera: x, y is the top left corner of cell (0, 0) and may be
+    // outside the window when the grid is zoomed in or panned, cell_size is the zoom
     SDL_Rect grid_dim;
     SDL_Renderer* renderer_used; // pointer to the renderer used
 
@@ -44,35 +50,95 @@ class GameGrid {
     SDL_Point mouse_poz; // used to store mouse position at last relevant position
 
     bool game_won;
-    SDL_Point start_win; // actual x coordonate, not position in grid
-    SDL_Point stop_win;
+    grid_line_data win_cells; // win line is placed when drawn, so it follows the camera
     SDL_Color color_win;
 
     std::vector<std::vector<cell_state>> grid_data; // matrix for cells data
 
+    // symbols drawn once per cell size (index: cell_state), nullptr if they could not be created
+    SDL_Texture* symbol_sprites[3];
+    int sprites_cell_size; // cell size the sprites were drawn for
+
+    // background and grid lines drawn once per layout into a target texture (nullptr if not supported)
+    SDL_Texture* background; // owned by the window
+    SDL_Texture* static_layer;
+    SDL_Rect static_layer_dim;
+
+    // buffers of the batched frame (kept between frames so they are not allocated again)
+    bool batched_rendering; // false after SDL_RenderGeometry failed once, symbols are then copied one by one
+    std::vector<SDL_Rect> line_rects;
+    std::vector<SDL_Vertex> symbol_vertices;
+    std::vector<SDL_Vertex> win_vertices;
+    int nr_draw_calls; // SDL draw calls of the last frame
+
+    bool camera_moved; // sprites and grid layer are drawn again before the next frame
+
+    // level of detail for small cells: one texel per cell (colored by its symbol), scaled when copied
+    SDL_Texture* lod_texture; // created the first time it is needed (nullptr before or if not supported)
+    bool lod_supported; // false after the texture could not be created, symbols are drawn instead
+
     const int margins = 50;
     const int thickness = 2;
+    const int min_cell_size = 4; // smallest zoom (big boards start at it and are panned)
+    const int lod_cell_size = 8; // cells smaller than this are drawn from lod_texture
 
     int get_vertical_fit_ratio(int height);     
+    // keeps part of the grid inside the window
+    void clamp_camera();
+    // first and last cells inside the window (first > last if none is), only these are drawn
+    void get_visible_cells(cell_pos& first, cell_pos& last);
+    // center of a cell in window coordinates
+    SDL_Point get_cell_center(cell_pos pos);
+    // draws X, 0 and Z into textures of cell_size (only when cell_size changed)
+    void build_symbol_sprites();
+    void destroy_symbol_sprites();
+    // draws background and grid lines into static_layer (falls back to drawing them every frame)
+    void build_static_layer();
+    void destroy_static_layer();
+    // all grid lines with a single call (rectangles with the same pixels as RenderThickLine)
+    void draw_grid_lines();
     void draw_cell(cell_pos pos, cell_state symbol_used);
+    // one batch of quads per sprite (cell by cell if batches are not supported)
+    void draw_symbols();
+    // true if cells are small enough to be drawn from lod_texture (creates it if needed)
+    bool use_lod();
+    // creates lod_texture and fills it from grid_data
+    void build_lod_texture();
+    void destroy_lod_texture();
+    // texel of a cell in lod_texture (ARGB8888, transparent if empty)
+    Uint32 get_lod_texel(cell_state state);
+    // copies the visible part of lod_texture over the visible cells with one call
+    void draw_lod();
     // function to draw a win line line that shows that a player had won
     void draw_win_line();
-    void clear_grid_data();
 
   public:
+    void clear_grid_data();
+    // also updates the texel of the cell if lod_texture exists
     void set_cell_state(cell_pos pos, cell_state state);
     // function used to signify that a player had won (also gives coordonates for winner line)
     void set_winner(grid_line_data data);
     void set_mouse_poz(SDL_Point point);
     // function to check whether mouse hovered over a valid cell (saves row and column)
     bool check_mouse_cell(cell_pos& pos);
+    // moves the grid by (dx, dy) pixels
+    void pan_camera(int dx, int dy);
+    // zooms in (steps > 0) or out (steps < 0), the point of the grid under focus stays in place
+    void zoom_camera(SDL_Point focus, int steps);
 
     GameGrid(SDL_Renderer* renderer, int grd_nr_rows, int grd_nr_cols, 
       SDL_Color col_grid, SDL_Color col_X, SDL_Color col_0, SDL_Color col_Z, SDL_Color col_win);
     ~GameGrid();
     void draw_grid();
+    int get_nr_draw_calls();
+    // true if draw_grid also draws the background
+    bool has_static_layer();
+    void set_background(SDL_Texture* texture);
     // function that should be used each time after window was resized to update grid
+    // (camera is reset so the grid fits the window, or is centered if it is too big to fit)
     void update_grid_dim();
+    // content of target textures was lost (SDL_RENDER_TARGETS_RESET), all textures if device_lost
+    void handle_render_reset(bool device_lost);
 
     void DEBUG_func();
 };
@@ -2,17 +2,62 @@
 #define GAME_LOGIC_H
 
 #include <vector>
+#include <memory>
+#include <random>
 #include <SDL2/SDL.h>
 
 #include "custom/utils.h"
+#include "custom/bitboard.h"
 
 class GameWindow;
 class GameGrid;
 class Player;
 
+// group of nr_win_line cells on a line, a player wins by filling a whole window
+struct win_window {
+    int start; // bit index of first cell
+    int step;  // bit distance between 2 cells of the window
+};
+
+// windows containing a cell along one direction (ids first .. first + count - 1)
+struct window_range {
+    int first;
+    int count;
+};
+
+// data that only depends on grid dimensions and nr_win_line
+// (built once per GameLogic construction and shared with its copies)
+// occupancy of a window (4 bytes, so a window is read with a single load)
+struct window_count {
+    unsigned char symbols[3]; // nr of cells of each symbol
+    unsigned char nr_used; // nr of non empty cells
+};
+
+struct GameTables {
+    std::vector<win_window> windows; // grouped by direction, then by line, in order along the line
+    int dir_first_window[5]; // windows of direction d are dir_first_window[d] .. dir_first_window[d + 1] - 1
+    std::vector<window_range> cell_windows; // index: bit index of cell * 4 + direction
+    std::vector<unsigned long long> zobrist_cells; // index: bit index of cell * 3 + symbol
+    unsigned long long zobrist_turns[3]; // one key per index of player to move
+    int nr_symmetries; // 8 for square grids (rotations and reflections), 4 otherwise (reflections)
+    std::vector<int> symmetry_cells; // index: bit index of cell * 8 + symmetry, value: bit index of its image
+    std::vector<long long> line_values; // line score of a window held by one symbol, index: nr of cells
+};
+
+// max nr of symmetries of a grid (symmetry 0 is the identity)
+const int MAX_SYMMETRIES = 8;
+
+// line values stop growing at 2^27: a board has less than 2^33 windows (4 per cell), so line scores
+// stay below 2^60, and heuristics are clamped below WIN_SCORE (about 2^30) anyway
+const int MAX_LINE_VALUE_SHIFT = 27;
+
+// board is kept as one bitboard per symbol, so a copy of a GameLogic
+// (e.g. a position for a search) is only a few words per symbol
 class GameLogic {
   private:
-    std::vector<std::vector<cell_state>> game_data;
+    Bitboard symbol_boards[3]; // cells marked with CELL_X, CELL_0 and CELL_Z
+    Bitboard valid_cells; // all cells of the grid (guard bits are not set)
+    int row_stride; // bits used by a row (nr_columns + 1 guard bit)
     int nr_used_cells;
     int nr_rows;
     int nr_columns;
@@ -20,12 +65,32 @@ class GameLogic {
     cell_pos cur_pos; // curent row and column where a cell was modified
     grid_line_data win_line_data;
 
-    // function to check if a group of nr_win_line contains only one symbol
-    // a row_dir of 0 means group is the same row (analog for row dir)
-    // a row dir of -1 or 1 means going to next or previous row in grid
-    // for going diagonally pick both row_dir and col_dir to be 1 (or -1 for bacwards diag)
-    // in case group is a mismatch, next group start cell for check is saved in start
-    bool check_group(cell_state target_state, cell_pos& start, int row_dir, int col_dir);
+    std::shared_ptr<const GameTables> tables;
+    // hashes[s] is the hash of the board transformed by symmetry s (hashes[0] is the board itself),
+    // all of them are updated in set_cell_state
+    unsigned long long hashes[MAX_SYMMETRIES];
+
+    // nr of cells of each symbol in each window, updated in set_cell_state
+    std::vector<window_count> window_counts;
+    int filled_window; // window filled by the last set_cell_state, -1 if none
+    // for each symbol: sum of 8 ^ (count - 1) over windows holding only that symbol
+    long long line_scores[3];
+
+    // sparse set of empty cells (in no particular order), updated in set_cell_state
+    // (empty_slots[bit index of cell] is the place of cell in empty_cells, -1 if it is not empty)
+    std::vector<cell_pos> empty_cells;
+    std::vector<int> empty_slots;
+
+    int cell_index(cell_pos pos);
+    cell_pos index_cell(int index);
+    void build_tables();
+    // check if all cells of a window are marked with symbol
+    bool check_window(int window, cell_state symbol);
+    // counters (and line scores) of a window that gets / loses a cell of symbol
+    void add_window_cell(int window, cell_state symbol);
+    void remove_window_cell(int window, cell_state symbol);
+    // win line data of a full window (DIR_DIAG2 win line is given from bottom left to top right)
+    void set_win_line(int window);
     bool check_win_row(cell_pos pos);
     bool check_win_column(cell_pos pos);
     bool check_win_diag1(cell_pos pos);
@@ -36,13 +101,47 @@ class GameLogic {
     cell_state get_cell_state(cell_pos pos);
     int get_nr_rows();
     int get_nr_columns();
+    int get_nr_win_line();
     int get_nr_used_cells();
     void set_cell_state(cell_pos pos, cell_state state);
-    // function to get cells with cell empty state
+    // function to get cells with cell empty state (row by row)
     std::vector<cell_pos> get_available_cells();
+    // same cells written into cells (no allocation once cells is big enough)
+    void get_available_cells(std::vector<cell_pos>& cells);
+    // view of the empty cells without scanning the board (order changes with every move)
+    const std::vector<cell_pos>& get_empty_cells();
+    // uniformly chosen empty cell in O(1) (there must be at least one)
+    cell_pos get_random_empty_cell(std::mt19937& rng);
+    // hash of the board (same board gives same hash, whatever the order of moves)
+    unsigned long long get_hash();
+    // key to combine with the board hash for the index of the player to move
+    unsigned long long get_turn_key(int player_index);
+    int get_nr_symmetries();
+    // same hash for every board equivalent by a symmetry of the grid (smallest of the transformed hashes)
+    // symmetry is set to the one that transforms the board into the canonical one
+    unsigned long long get_canonical_hash(int& symmetry);
+    // true if symmetry maps the board onto itself (compared by hash)
+    bool is_symmetric(int symmetry);
+    // image of pos by a symmetry, and the symmetry that undoes it
+    cell_pos transform_cell(cell_pos pos, int symmetry);
+    int inverse_symmetry(int symmetry);
+    int get_nr_windows();
+    // windows containing pos along direction dir
+    window_range get_cell_windows(cell_pos pos, win_direction dir);
+    // nr of cells of a window marked with symbol
+    int get_window_count(int window, cell_state symbol);
+    // strength of the open lines of symbol: sum of 8 ^ (count - 1) over windows no other symbol
+    // has entered (counts are capped at nr_win_line - 1)
+    long long get_line_score(cell_state symbol);
 
-    // check if last move conducted to a win 
+    // check if last move conducted to a win (lookup of the windows counters, no scan)
+    // answer is cached by set_cell_state and only covers its last call: it is false after a cell is
+    // emptied (e.g. a search reverting a move) or after clear_game_data, even if an older move
+    // still fills a window (check_win_direction on a cell of that move finds such windows)
     bool check_win();
+    // function to check if one of the windows along a direction that contain pos is full of pos's symbol
+    // windows are tried in order along the line (sets the win line like check_win)
+    bool check_win_direction(cell_pos pos, win_direction dir);
     grid_line_data get_win_line_data();
 
     GameLogic(int n_rows, int n_cols, int n_win_line);
@@ -66,10 +165,27 @@ class GameManager {
     int nr_players;
     int cur_player;
 
+    Uint32 robot_event_type; // event robots push when their move is ready (0 if it could not be registered)
+    bool frame_dirty; // something changed since the last rendered frame
+    long long nr_frames_rendered;
+    long long nr_frames_skipped; // loop wake ups where nothing had to be drawn
+    bool resize_pending; // window was resized, layout is updated once before the next frame
+    long long nr_relayouts_skipped; // resize events replaced by a later one before being applied
+
     void add_player(player_type type, cell_state symbol, robot_difficulty diff);
     void change_player_turn();
     bool decide_win_or_draw(); //function to decide ppotential win or draw and make necessary changes
+    // clears the grid for a new game (stops robots that are thinking)
+    void reset_game();
     void handle_resize_event();
+    // applies the last window size of a burst of resize events (if any arrived)
+    void apply_pending_resize();
+    // reacts to one event (sets run_game to false if the game ended or the window was closed)
+    void handle_event(bool& run_game);
+    // makes the moves of robots that are ready, starts the search of the next robot
+    void play_robot_turns(bool& run_game);
+    // draws a frame only if something changed since the last one
+    void render_frame();
 
     void DEBUG_func();
 
@@ -77,6 +193,9 @@ class GameManager {
     GameManager();
     ~GameManager();
     void game_loop();
+    long long get_nr_frames_rendered();
+    long long get_nr_frames_skipped();
+    long long get_nr_relayouts_skipped();
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,46 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <iostream>
+
+// log levels, chosen at compile time with -DLOG_LEVEL=...
+// messages above the chosen level are removed by the preprocessor (no I/O, no evaluated arguments)
+#define LOG_LEVEL_NONE  0
+#define LOG_LEVEL_ERROR 1 // setup failures (SDL, assets, invalid modifiers)
+#define LOG_LEVEL_INFO  2 // game events (draw, robot statistics)
+#define LOG_LEVEL_DEBUG 3 // state dumps after each action
+#define LOG_LEVEL_TRACE 4 // dumps from hot paths (every win check of every search node)
+
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_ERROR // release build
+#endif
+
+// usage: LOG_INFO("nr nodes: " << nr_nodes << "\n");
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_ERROR(msg) do { std::cerr << msg; } while (0)
+#else
+#define LOG_ERROR(msg) do {} while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFO(msg) do { std::cout << msg; } while (0)
+#else
+#define LOG_INFO(msg) do {} while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(msg) do { std::cout << msg; } while (0)
+// runs code only in debug builds (e.g. DEBUG_func dumps)
+#define LOG_DEBUG_RUN(code) do { code; } while (0)
+#else
+#define LOG_DEBUG(msg) do {} while (0)
+#define LOG_DEBUG_RUN(code) do {} while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_TRACE
+#define LOG_TRACE(msg) do { std::cout << msg; } while (0)
+#else
+#define LOG_TRACE(msg) do {} while (0)
+#endif
+
+#endif
@@ -0,0 +1,66 @@
+#ifndef MCTS_H
+#define MCTS_H
+
+#include <bits/stdc++.h>
+
+#include "custom/utils.h"
+#include "custom/game_logic.h"
+
+// weight of the exploration term in UCT (sqrt(2) for rewards between 0 and 1)
+const float MCTS_EXPLORATION = 1.41f;
+
+struct mcts_node {
+    int first_child; // children of a node are next to each other in the pool, -1 until expanded
+    int nr_children;
+    int move; // cell index (row * nr_columns + column) played to reach the node
+    int nr_visits;
+    float total_reward; // sum of playout results for the player who played move (win 1, draw 0.5)
+};
+
+// UCT search: the tree is grown one level at a time from the most promising leaf,
+// leaves are scored by finishing the game with random moves
+class MctsEngine {
+  private:
+    cell_state used_symbol;
+    std::vector<cell_state>& symbols_order; // reference to symbols order
+    GameModifiers& modifiers; // reference to game modifiers (playout budget)
+    std::atomic<bool>& cancel_requested; // shared with the robot that owns the engine
+    GameLogic search_logic; // private copy of the position
+    std::mt19937 rng; // random playouts (seed comes from the owning robot)
+
+    std::vector<mcts_node> pool; // allocated once, reused by every search
+    int nr_used_nodes;
+
+    // cells still empty in the simulated game are the empty cells of search_logic
+    // (kept by set_cell_state, so a move is removed in O(1))
+    std::vector<int> path; // nodes visited by current iteration, root first
+    std::vector<int> played_cells; // cells marked by current iteration (reverted at its end)
+
+    int root_player;
+    long long nr_playouts; // nr of playouts of last search
+    double search_time_ms;
+
+    // marks cell for the player with index player in symbols_order
+    void play_cell(int cell, int player);
+    void revert_played_cells();
+    // child of node with the best UCT value (unvisited children first)
+    int select_child(int node);
+    // adds a child for every free cell (does nothing if the pool is full)
+    void expand(int node);
+    // plays random moves until the game ends, returns index of the winner or -1 for a draw
+    int random_playout(int player);
+    // one selection, expansion, playout and backpropagation step
+    void run_iteration();
+
+  public:
+    MctsEngine(cell_state s, const GameLogic& position, std::vector<cell_state>& symb_order,
+      GameModifiers& game_modifiers, std::atomic<bool>& cancel, unsigned int seed);
+
+    // most visited move of the position (there must be at least one empty cell)
+    cell_pos search(const GameLogic& position);
+    long long get_nr_playouts();
+    double get_playouts_per_second();
+    int get_nr_used_nodes();
+};
+
+#endif
@@ -0,0 +1,16 @@
+#ifndef PERFECT_PLAY_H
+#define PERFECT_PLAY_H
+
+#include "custom/utils.h"
+#include "custom/game_logic.h"
+
+// true for the classic game: 3x3 grid, 3 in a row, 2 players
+bool is_classic_game(GameLogic& logic, int nr_players);
+
+// best move of a classic game position for the player with symbol mover, read from a table
+// built at compile time (same cell minimax picks: first one in row order with the best value)
+// value is 1 for a forced win of mover, -1 for a forced loss and 0 for a draw
+// returns false if the game is over (win or full grid)
+bool perfect_play_move(GameLogic& logic, cell_state mover, cell_pos& pos, int& value);
+
+#endif
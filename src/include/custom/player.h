@@ -5,6 +5,9 @@
 
 #include "custom/utils.h"
 #include "custom/game_logic.h"
+#include "custom/transposition_table.h"
+#include "custom/search_engine.h"
+#include "custom/mcts.h"
 
 // abstract class
 class Player {
@@ -19,7 +22,10 @@ class Player {
     virtual ~Player();
     player_type get_type();
 
+    // returns true once an action was made (robots may need several calls while they think)
     virtual bool do_next_action() = 0;
+    // stops an action in progress (window closed or game reset)
+    virtual void cancel_action();
 };
 
 class Human : public Player {
@@ -36,38 +42,82 @@ class Robot : public Player  {
   private:
     robot_difficulty difficulty;
     std::vector<cell_state>& symbols_order; // reference to symbols order
-  
-    // helper variables for different robot functions
-    std::vector<cell_pos> available_cells;
-    std::vector<bool> marked_cells;
-    std::stack<cell_pos> moves_record;
-    int cur_player;
-    int nr_players;
-
-    // helper functions used for higher difficulties robots
-  
-    void next_player_turn();
-    void last_player_turn();
-    // check if current game state is terminal
-    bool is_terminal(bool& win_termination);
-    // returns a "score" based on favorability for the curent player (in a terminal state)
-    int evaluate_game_state(bool& win_termination);
-    void simulate_player_action(cell_pos pos);
-    void revert_action_simulation();
-    cell_pos minimax();
-    // helper function that calls itself recursively
-    int minimax_helper(int cur_depth, int max_depth, cell_pos& optimal_pos);
-
-    void robot_round_setup();
-    bool easy_robot_action();
-    bool hard_robot_action();
+    GameModifiers& modifiers; // reference to game modifiers (search settings)
+    GameLogic search_position; // snapshot of the live position the search starts from
+    TranspositionTable transposition_table; // positions already searched (kept between rounds)
+    std::vector<SearchEngine*> engines; // one per search thread, first one runs on the calling thread
+    MctsEngine* mcts_engine; // only for MCTS robots
+    std::mt19937 rng; // moves of EASY robots (seeded from std::random_device unless robot_seed is set)
+    long long nr_nodes; // nr of positions visited by last search (all threads)
+    long long nr_tt_hits;
+    int completed_depth; // depth of last finished iteration (whole game for full searches)
+
+    // root split: every thread takes the next unsearched root move until none is left
+    std::vector<int> root_moves; // indexes of root moves in search order
+    std::atomic<int> next_root_move;
+    std::mutex root_mutex; // guards best_root_val and best_root_index
+    int best_root_val;
+    int best_root_index;
+    int root_depth;
+
+    // helper threads live for a whole search and are woken up for every depth
+    // (helper i - 1 searches with engines[i], the calling thread with engines[0])
+    std::vector<std::thread> helpers;
+    std::mutex helpers_mutex; // guards the helper fields below
+    std::condition_variable helpers_wake; // a depth was started or helpers must stop
+    std::condition_variable helpers_done; // last busy helper finished its part of a depth
+    int helpers_round; // incremented for every depth
+    int nr_active_helpers; // helpers taking part in the current depth
+    int nr_busy_helpers;
+    bool helpers_stop;
+
+    cell_pos easy_robot_move();
+    cell_pos hard_robot_move();
+    cell_pos mcts_robot_move();
+    // searches root_moves[i] and keeps it if it beats the best root move so far
+    void search_root_task(SearchEngine* engine, int i);
+    // takes root moves until none is left or the search is aborted
+    void root_split_worker(SearchEngine* engine);
+    // starts one helper per engine except the first (nothing for a single engine)
+    void start_helpers();
+    void stop_helpers();
+    // waits for depths and takes part in them until stop_helpers
+    void helper_loop(int engine_index);
+    // alpha-beta search of the root split between threads, returns false if it was aborted
+    // (picks the same cell as a single thread: first one in row order with the best value)
+    bool parallel_alpha_beta(int max_depth, cell_pos& optimal_pos);
+    // picks next move for the position in search_position
+    bool search_action(cell_pos& pos);
+
+    // asynchronous search (do_next_action starts it, then polls for its result)
+    std::thread search_thread;
+    bool searching; // a search was started and its result was not applied yet
+    std::atomic<bool> result_ready;
+    std::atomic<bool> cancel_requested;
+    bool result_found; // written by the search thread before result_ready
+    cell_pos result_pos;
+    Uint32 result_event_type; // SDL event pushed when a search ends (0 for none)
+    void search_worker();
 
   public:
-    Robot(cell_state s, GameLogic* gl, GameGrid* gg, 
-      robot_difficulty diff, std::vector<cell_state>& symb_order); 
+    Robot(cell_state s, GameLogic* gl, GameGrid* gg, robot_difficulty diff,
+      std::vector<cell_state>& symb_order, GameModifiers& game_modifiers); 
     ~Robot() override;
 
+    // picks next move without making it, on the calling thread (returns false if no move is possible)
+    bool compute_action(cell_pos& pos);
+    long long get_nr_nodes();
+    long long get_nr_tt_hits();
+    int get_completed_depth();
+    int get_nr_threads();
+    long long get_nr_playouts();
+    double get_playouts_per_second();
+
+    // event the search thread pushes once a move is ready, so an event loop can sleep meanwhile
+    void set_result_event(Uint32 event_type);
+    // starts a search on a worker thread, the move is made by the first call after it ends
     bool do_next_action() override;
+    void cancel_action() override;
 };
 
 #endif
\ No newline at end of file
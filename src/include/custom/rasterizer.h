@@ -0,0 +1,25 @@
+#ifndef RASTERIZER_H
+#define RASTERIZER_H
+
+#include <SDL2/SDL.h>
+#include <vector>
+
+// shapes of the symbols are computed as horizontal spans (rects of height 1), so a whole
+// shape is drawn with a single SDL_RenderFillRects call instead of a call per line or pixel
+// (spans are added to the end of the vector, it is not cleared)
+
+// ring of the 0 symbol: pixels of dimensions whose (truncated) distance to the center differs
+// from the radius by less than thickness, found row by row with integer math (no sqrt per pixel)
+void RasterizeRing(std::vector<SDL_Rect>& spans, SDL_Rect dimensions, int thickness);
+
+// thick line from start to stop: a quad that is 2 * thickness - 1 pixels wide measured
+// perpendicular to the line (so diagonals are as thick as horizontal and vertical lines)
+void RasterizeStroke(std::vector<SDL_Rect>& spans, SDL_Point start, SDL_Point stop, int thickness);
+
+// corners of the quad covered by RasterizeStroke (in pixel coordinates, pixel (x, y) is the point (x, y))
+void StrokeCorners(SDL_FPoint corners[4], SDL_Point start, SDL_Point stop, int thickness);
+
+// draws the spans, returns the nr of SDL draw calls (0 if there are no spans)
+int RenderSpans(SDL_Renderer *renderer, const std::vector<SDL_Rect>& spans);
+
+#endif
@@ -0,0 +1,106 @@
+#ifndef SEARCH_ENGINE_H
+#define SEARCH_ENGINE_H
+
+#include <bits/stdc++.h>
+
+#include "custom/utils.h"
+#include "custom/game_logic.h"
+#include "custom/transposition_table.h"
+
+// score of a won game for the robot (lost game is -WIN_SCORE, draw is 0)
+const int WIN_SCORE = 1000000000;
+// ints of the search arena allocated by the constructor (about 4 MB), big boards grow it when
+// an iteration goes deeper than the plies that fit
+const size_t ARENA_PRESIZED_INTS = 1 << 20;
+
+// search state of one thread (robots split the root moves between several engines)
+// every engine simulates moves on its own copy of the position, only the transposition table
+// and the cancel flag are shared
+class SearchEngine {
+  private:
+    cell_state used_symbol; // symbol of the robot the engine searches for
+    std::vector<cell_state>& symbols_order; // reference to symbols order
+    GameModifiers& modifiers; // reference to game modifiers (search settings)
+    TranspositionTable& transposition_table; // shared by all engines of a robot
+    std::atomic<bool>& cancel_requested; // shared by all engines of a robot
+    GameLogic search_logic; // private copy of the position
+
+    // helper variables for different search functions
+    // every buffer is allocated by the constructor, sized for the empty board, so a search never allocates
+    // (except the arena of big boards, which grows between iterations when they get deeper)
+    std::vector<cell_pos> available_cells;
+    std::vector<unsigned char> marked_cells; // bytes, not packed bits
+    std::vector<cell_pos> moves_record; // simulated moves, last one at the back
+    std::vector<int> center_order; // indexes in available_cells sorted by distance to center
+    // arena of ints: scratch values of the moves (nr cells), then a stack with the move order of
+    // every ply of the current line (at most nr cells ints per ply)
+    std::vector<int> search_arena;
+    int order_top; // first free int of the order stack
+    int cur_player;
+    long long nr_nodes; // nr of positions visited since round_setup
+    long long nr_tt_hits; // nr of positions found in transposition table since round_setup
+    bool search_aborted; // time budget ran out (or cancel was requested) during current iteration
+    bool time_limited; // current iteration can be stopped by the time budget
+    std::chrono::steady_clock::time_point search_deadline;
+
+    void next_player_turn();
+    void last_player_turn();
+    // check if current game state is terminal
+    bool is_terminal(bool& win_termination);
+    // returns a "score" based on favorability for the curent player (in a terminal state)
+    int evaluate_game_state(bool& win_termination);
+    // estimated score of a non terminal state (search horizon), always between -WIN_SCORE and WIN_SCORE
+    int evaluate_heuristic();
+    // checks time budget and cancel requests of the current search (sets search_aborted)
+    bool search_should_stop();
+    void simulate_player_action(cell_pos pos);
+    void revert_action_simulation();
+    // hash of the simulated position including the player to move
+    // (with robot_symmetry the canonical hash, symmetry is set to the transform into the canonical board)
+    unsigned long long position_key(int& symmetry);
+    // moves are kept in the transposition table as cell indexes of the canonical board
+    int key_move(cell_pos pos, int symmetry);
+    int board_move(int move, int symmetry);
+    // nr of moves left to simulate from current position
+    int remaining_moves();
+    // helper function that calls itself recursively (checks transposition table first)
+    int minimax_helper(int cur_depth, int max_depth, cell_pos& optimal_pos);
+    // explores every move of a position not found in transposition table
+    int minimax_search(int cur_depth, int max_depth, cell_pos& optimal_pos);
+    // same result as minimax_helper below the root, but skips branches that can't change the result
+    // (positions max_depth moves away from root get a heuristic score)
+    int alpha_beta_helper(int cur_depth, int max_depth, int alpha, int beta);
+    // score of a cell for the player to move (open lines he can extend or must block)
+    int cell_line_potential(cell_pos pos);
+    // fills order with unexplored indexes of available_cells, best candidates first, returns their nr
+    // (hash_move is a cell index suggested by the transposition table, -1 if none)
+    int order_moves(int* order, int hash_move);
+
+  public:
+    SearchEngine(cell_state s, const GameLogic& position, std::vector<cell_state>& symb_order,
+      GameModifiers& game_modifiers, TranspositionTable& tt, std::atomic<bool>& cancel);
+
+    // copies the position to search and resets the round statistics
+    void round_setup(const GameLogic& position);
+    // limits of the next iteration, searched max_depth plies deep (no deadline if limited is false)
+    void start_iteration(int max_depth, bool limited, std::chrono::steady_clock::time_point deadline);
+
+    int get_nr_moves();
+    cell_pos get_move(int index);
+    long long get_nr_nodes();
+    long long get_nr_tt_hits();
+    bool is_aborted();
+
+    // full minimax search of the whole game (first cell in row order with the best value)
+    cell_pos minimax_move();
+    // indexes of the root moves in the order they should be searched
+    // (with robot_symmetry only the first cell in row order of each group of equivalent moves)
+    void root_order(std::vector<int>& order);
+    // value of a root move searched max_depth plies deep
+    // (exact if bigger than alpha, otherwise only an upper bound)
+    int search_root_move(int index, int max_depth, int alpha);
+    // saves the result of a finished root search for the next iterations and rounds
+    void store_root(int max_depth, int value, int index);
+};
+
+#endif
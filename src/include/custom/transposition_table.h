@@ -0,0 +1,56 @@
+#ifndef TRANSPOSITION_TABLE_H
+#define TRANSPOSITION_TABLE_H
+
+#include <vector>
+#include <atomic>
+
+// what the stored value means (alpha-beta may only find a bound of the real value)
+enum tt_bound {
+    TT_EXACT,
+    TT_LOWER, // real value is >= stored value
+    TT_UPPER  // real value is <= stored value
+};
+
+// biggest stored depth, deeper searches are stored with this depth, so probes compare
+// min(depth, TT_MAX_DEPTH) (boards up to TT_MAX_DEPTH cells never saturate)
+const int TT_MAX_DEPTH = (1 << 14) - 1;
+
+struct tt_entry {
+    unsigned long long key;
+    int value;
+    int best_move;       // cell index (row * nr_columns + column), -1 if unknown
+    int depth;           // nr of plies searched below the position (saturates at TT_MAX_DEPTH)
+    tt_bound bound;
+    unsigned char age;   // search that wrote the entry (2 bits)
+};
+
+// slot shared by all search threads without locks: data holds the packed entry and
+// check is key ^ data, so a slot torn by 2 threads writing at once fails the key check (a miss)
+struct tt_slot {
+    std::atomic<unsigned long long> check;
+    std::atomic<unsigned long long> data;
+};
+
+// fixed size hash table of already searched positions
+// every bucket has 2 slots: first one keeps the deepest (or newest) search,
+// second one is always replaced
+class TranspositionTable {
+  private:
+    std::vector<tt_slot> slots;
+    unsigned long long bucket_mask;
+    unsigned char cur_age;
+
+    unsigned long long pack(int value, int depth, tt_bound bound, int best_move);
+    tt_entry unpack(unsigned long long key, unsigned long long data);
+
+  public:
+    // size_mb == 0 gives a disabled table (probe always misses, store does nothing)
+    TranspositionTable(int size_mb);
+    void clear();
+    // call before each robot search so entries of older searches are replaced first
+    void new_search();
+    bool probe(unsigned long long key, tt_entry& entry);
+    void store(unsigned long long key, int value, int depth, tt_bound bound, int best_move);
+};
+
+#endif
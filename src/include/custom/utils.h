@@ -2,6 +2,7 @@
 #define UTILS_H
 
 #include <SDL2/SDL.h>
+#include <vector>
 
 enum player_type {
     HUMAN,
@@ -18,9 +19,32 @@ enum cell_state {
 enum robot_difficulty {
     EASY,
     HARD,
+    MCTS, // monte carlo tree search, for boards too big for HARD
     HUMAN_DIFF // <=> "NULL" for this enum
 };
 
+// directions of lines that can win the game
+enum win_direction {
+    DIR_ROW,
+    DIR_COLUMN,
+    DIR_DIAG1, // down to the right
+    DIR_DIAG2  // down to the left
+};
+
+// search algorithm used by HARD robots
+enum search_mode {
+    SEARCH_MINIMAX,   // plain minimax, explores the full game tree
+    SEARCH_ALPHA_BETA, // minimax with alpha-beta pruning (same move, fewer nodes)
+    SEARCH_ITERATIVE   // alpha-beta one ply deeper at a time, until robot_time_budget runs out
+};
+
+// order in which a robot tries moves during alpha-beta search
+enum move_ordering {
+    ORDER_NONE,          // row by row, same order as get_available_cells
+    ORDER_CENTER,        // cells closer to the grid center first
+    ORDER_LINE_POTENTIAL // cells that open or block more lines first
+};
+
 
 struct cell_pos {
     int row;
@@ -57,8 +81,19 @@ struct GameModifiers {
     cell_state symbol3; // type of thirth player
     robot_difficulty diff3;
 
-    int small_delay; // delay in ms
-    int big_delay;
+    int big_delay; // delay in ms before the window closes at the end of a game
+    int idle_timeout; // longest sleep in ms of the game loop while waiting for events (input and robot moves wake it)
+
+    search_mode robot_search; // search used by HARD robots
+    move_ordering robot_ordering; // move ordering used by alpha-beta search
+    int tt_size_mb; // memory of each robot transposition table in MB (0 disables it)
+    int robot_time_budget; // time in ms a robot may think in SEARCH_ITERATIVE mode
+    int robot_threads; // threads used by alpha-beta searches (0 for all cores)
+    bool robot_symmetry; // searches treat positions equivalent by a rotation or reflection as one
+    bool robot_perfect_table; // HARD robots play the classic 3x3 game from a table built at compile time
+    int mcts_playouts; // playouts of a MCTS robot per move (0 to play until robot_time_budget runs out)
+    int mcts_pool_nodes; // nr of tree nodes a MCTS robot allocates once (tree stops growing when full)
+    unsigned int robot_seed; // seed of the random moves of a robot (0 for a different one every launch)
 
     GameModifiers(); // change this function to easily change game modifiers
 };
@@ -66,15 +101,21 @@ struct GameModifiers {
 long PointsDist(SDL_Point p1, SDL_Point p2);
 long LineSlope(SDL_Point p1, SDL_Point p2);
 
-void RenderThickLine(SDL_Renderer *renderer, SDL_Point start, SDL_Point stop, int thickness);
-void RenderX(SDL_Renderer *renderer, SDL_Rect dimensions, int thickness);
-void Render0(SDL_Renderer *renderer, SDL_Rect dimensions, int thickness);
-void RenderZ(SDL_Renderer *renderer, SDL_Rect dimensions, int thickness);
+// render helpers return the nr of SDL draw calls they issued (shapes come from the scanline
+// rasterizer, so a symbol or a line is a single call)
+int RenderThickLine(SDL_Renderer *renderer, SDL_Point start, SDL_Point stop, int thickness);
+int RenderX(SDL_Renderer *renderer, SDL_Rect dimensions, int thickness);
+int Render0(SDL_Renderer *renderer, SDL_Rect dimensions, int thickness);
+int RenderZ(SDL_Renderer *renderer, SDL_Rect dimensions, int thickness);
+
+// batched versions: two triangles are added to vertices, they are drawn later with a single
+// SDL_RenderGeometry call for the whole batch
+void AddThickLineQuad(std::vector<SDL_Vertex>& vertices, SDL_Point start, SDL_Point stop, int thickness,
+    SDL_Color color);
+// quad showing a whole texture in dimensions
+void AddTexturedQuad(std::vector<SDL_Vertex>& vertices, SDL_Rect dimensions);
  
-// resize a surface to a desired size
-SDL_Surface* ResizeSurface(SDL_Surface* original_surface, int window_width, int window_height);
-// creeate a texture of desired size from a surface
-SDL_Texture* CreateSizedTexture(SDL_Renderer* renderer, SDL_Surface* original_surface, int window_width, int window_height);
-SDL_Texture* CreateSizedTextureFromBMP(SDL_Renderer *renderer, const char *image_file_name, int window_width, int window_height);
+// decode an image once into a texture of its own size (scaled by the renderer when copied)
+SDL_Texture* CreateTextureFromBMP(SDL_Renderer *renderer, const char *image_file_name);
 
 #endif
\ No newline at end of file
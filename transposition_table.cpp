@@ -0,0 +1,114 @@
+#include <vector>
+#include <atomic>
+#include <algorithm>
+
+#include "custom/transposition_table.h"
+
+// layout of a packed entry:
+// bits 0-31 value, 32-45 best move + 1 (0 if unknown), 46-59 depth, 60-61 bound, 62-63 age
+// (move and depth get 14 bits each, both only need the nr of cells of the board)
+const int MOVE_SHIFT = 32;
+const int DEPTH_SHIFT = 46;
+const int BOUND_SHIFT = 60;
+const int AGE_SHIFT = 62;
+const unsigned long long FIELD_MASK = (1ULL << 14) - 1; // move and depth fields
+const int MAX_PACKED_MOVE = (1 << 14) - 2;
+
+TranspositionTable::TranspositionTable(int size_mb)
+    : bucket_mask(0), cur_age(0) {
+
+    // use the biggest power of 2 nr of buckets that fits in the given memory
+    unsigned long long max_slots = (unsigned long long)size_mb * 1024 * 1024 / sizeof(tt_slot);
+    unsigned long long nr_buckets = 1;
+
+    if (max_slots >= 2) {
+        while (nr_buckets * 4 <= max_slots) {
+            nr_buckets *= 2;
+        }
+        slots = std::vector<tt_slot>(nr_buckets * 2);
+        bucket_mask = nr_buckets - 1;
+    }
+
+    clear();
+}
+
+void TranspositionTable::clear() {
+    for (tt_slot& slot : slots) {
+        slot.check.store(0, std::memory_order_relaxed);
+        slot.data.store(0, std::memory_order_relaxed); // data 0 marks an empty slot
+    }
+}
+
+void TranspositionTable::new_search() {
+    cur_age = (cur_age + 1) & 3;
+}
+
+unsigned long long TranspositionTable::pack(int value, int depth, tt_bound bound, int best_move) {
+    // moves that don't fit are dropped (entry is still valid, only without a move to try first)
+    unsigned long long packed_move = best_move >= 0 && best_move <= MAX_PACKED_MOVE ? best_move + 1 : 0;
+    unsigned long long packed_depth = std::min(depth, TT_MAX_DEPTH);
+
+    return (unsigned long long)(unsigned int)value
+        | packed_move << MOVE_SHIFT
+        | packed_depth << DEPTH_SHIFT
+        | (unsigned long long)bound << BOUND_SHIFT
+        | (unsigned long long)cur_age << AGE_SHIFT;
+}
+
+tt_entry TranspositionTable::unpack(unsigned long long key, unsigned long long data) {
+    tt_entry entry;
+
+    entry.key = key;
+    entry.value = (int)(unsigned int)(data & 0xFFFFFFFFULL);
+    entry.best_move = (int)((data >> MOVE_SHIFT) & FIELD_MASK) - 1;
+    entry.depth = (data >> DEPTH_SHIFT) & FIELD_MASK;
+    entry.bound = (tt_bound)((data >> BOUND_SHIFT) & 3);
+    entry.age = (data >> AGE_SHIFT) & 3;
+
+    return entry;
+}
+
+bool TranspositionTable::probe(unsigned long long key, tt_entry& entry) {
+    if (slots.empty()) {
+        return false;
+    }
+
+    tt_slot* bucket = &slots[(key & bucket_mask) * 2];
+
+    for (int i = 0; i < 2; i++) {
+        unsigned long long data = bucket[i].data.load(std::memory_order_relaxed);
+        unsigned long long check = bucket[i].check.load(std::memory_order_relaxed);
+
+        if (data != 0 && (check ^ data) == key) {
+            entry = unpack(key, data);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void TranspositionTable::store(unsigned long long key, int value, int depth, tt_bound bound, int best_move) {
+    if (slots.empty()) {
+        return;
+    }
+
+    tt_slot* bucket = &slots[(key & bucket_mask) * 2];
+    tt_slot* slot = &bucket[1];
+
+    // first slot is only given up for a deeper search or if it is left from an older search
+    unsigned long long first_data = bucket[0].data.load(std::memory_order_relaxed);
+    tt_entry first = unpack(bucket[0].check.load(std::memory_order_relaxed) ^ first_data, first_data);
+    if (first_data == 0 || first.key == key || first.age != cur_age || std::min(depth, TT_MAX_DEPTH) >= first.depth) {
+        slot = &bucket[0];
+
+        unsigned long long second_data = bucket[1].data.load(std::memory_order_relaxed);
+        if ((bucket[1].check.load(std::memory_order_relaxed) ^ second_data) == key) {
+            bucket[1].data.store(0, std::memory_order_relaxed); // don't keep a second copy of the same position
+        }
+    }
+
+    unsigned long long data = pack(value, depth, bound, best_move);
+    slot->data.store(data, std::memory_order_relaxed);
+    slot->check.store(key ^ data, std::memory_order_relaxed);
+}
@@ -3,6 +3,8 @@
 #include <iostream>
 
 #include <custom/utils.h>
+#include <custom/rasterizer.h>
+#include <custom/logger.h>
 
 GameModifiers::GameModifiers() {
     nr_rows = 3;
@@ -29,8 +31,19 @@ GameModifiers::GameModifiers() {
     symbol3 = CELL_Z;
     diff3 = HUMAN_DIFF;
 
-    small_delay = 20; // delay in ms
-    big_delay = 2000;
+    big_delay = 2000; // delay in ms
+    idle_timeout = 500;
+
+    robot_search = SEARCH_ITERATIVE;
+    robot_ordering = ORDER_LINE_POTENTIAL;
+    tt_size_mb = 16;
+    robot_time_budget = 1000;
+    robot_threads = 0;
+    robot_symmetry = true;
+    robot_perfect_table = true;
+    mcts_playouts = 0;
+    mcts_pool_nodes = 1 << 19;
+    robot_seed = 0;
 }
 
 long PointsDist(SDL_Point p1, SDL_Point p2) {
@@ -47,152 +60,116 @@ long LineSlope(SDL_Point p1, SDL_Point p2) {
     return 1000.0; // really big slope to avoid dividing by 0 in slope formula
 }
 
-void RenderThickLine(SDL_Renderer *renderer, SDL_Point start, SDL_Point stop, int thickness) {
-    long slope; 
-
-    slope = LineSlope(start, stop);
-
-    // draw "base line"
-    SDL_RenderDrawLine(renderer, start.x, start.y, stop.x, stop.y);
-
-    // draw the "thickness"
-    if (abs(slope) > 1) {
-        // if "slope" > 1 => line is "somewhat" vertical
-        for (int i = 0; i < thickness; i++) {
-            SDL_RenderDrawLine(renderer, start.x + i, start.y, stop.x + i, stop.y);
-            SDL_RenderDrawLine(renderer, start.x - i, start.y, stop.x - i, stop.y);
-        }
-    } else {
-        // if "slope" <= 1 => line is "somewhat" horizontal
-        for (int i = 0; i < thickness; i++) {
-            SDL_RenderDrawLine(renderer, start.x, start.y + i, stop.x, stop.y + i);
-            SDL_RenderDrawLine(renderer, start.x, start.y - i, stop.x, stop.y - i);
-        }
-    }
+int RenderThickLine(SDL_Renderer *renderer, SDL_Point start, SDL_Point stop, int thickness) {
+    std::vector<SDL_Rect> spans;
+    RasterizeStroke(spans, start, stop, thickness);
+    return RenderSpans(renderer, spans);
 }
 
-void RenderX(SDL_Renderer *renderer, SDL_Rect dimensions, int thickness) {
+int RenderX(SDL_Renderer *renderer, SDL_Rect dimensions, int thickness) {
     int offset = std::min(dimensions.w, dimensions.h) / 10; // offset so it doesn t touch margins
+    std::vector<SDL_Rect> spans; // both lines are drawn with one call
 
-    RenderThickLine(renderer, 
+    RasterizeStroke(spans, 
         {dimensions.x + offset, dimensions.y + offset}, 
         {dimensions.x + dimensions.w - offset, dimensions.y + dimensions.h - offset}, 
         thickness
     );
 
-    RenderThickLine(renderer, 
+    RasterizeStroke(spans, 
         {dimensions.x + offset, dimensions.y + dimensions.h - offset}, 
         {dimensions.x + dimensions.w - offset, dimensions.y + offset}, 
         thickness
     );
-}
-
-void Render0(SDL_Renderer *renderer, SDL_Rect dimensions, int thickness) {
-    int radius;
-    SDL_Point center;
-    SDL_Point cur_point;
-    long deviation;
 
-    center.x = dimensions.x + dimensions.w / 2;
-    center.y = dimensions.y + dimensions.h / 2;
-    radius = std::min(dimensions.h, dimensions.w) * 8 / 20; // we let a 10 % offset (/ 2 / 10)
-
-    for (int i = 0; i < dimensions.w; i++) {
-        for (int j = 0; j < dimensions.h; j++) {
-            cur_point.x = dimensions.x + i;
-            cur_point.y = dimensions.y + j;
-
-            deviation = abs(PointsDist(cur_point, center) - radius);
+    return RenderSpans(renderer, spans);
+}
 
-            if (deviation < 0.5 || deviation < thickness) { // deviations < 0.5 <=> thickness == 0
-                SDL_RenderDrawPoint(renderer, cur_point.x, cur_point.y);
-            }
-        }
-    }
+int Render0(SDL_Renderer *renderer, SDL_Rect dimensions, int thickness) {
+    std::vector<SDL_Rect> spans;
+    RasterizeRing(spans, dimensions, thickness);
+    return RenderSpans(renderer, spans);
 }
 
-void RenderZ(SDL_Renderer *renderer, SDL_Rect dimensions, int thickness) {
+int RenderZ(SDL_Renderer *renderer, SDL_Rect dimensions, int thickness) {
     int offset = std::min(dimensions.w, dimensions.h) / 10; // offset so it doesn t touch margins
+    std::vector<SDL_Rect> spans; // all three lines are drawn with one call
 
-    // draw upper line
-    RenderThickLine(renderer, 
+    // upper line
+    RasterizeStroke(spans, 
         {dimensions.x + offset, dimensions.y + offset}, 
         {dimensions.x + dimensions.w - offset, dimensions.y + offset}, 
         thickness
     );
 
-    // draw diag line
-    RenderThickLine(renderer, 
+    // diag line
+    RasterizeStroke(spans, 
         {dimensions.x + dimensions.w - offset, dimensions.y + offset}, 
         {dimensions.x + offset, dimensions.y + dimensions.h - offset}, 
         thickness
     );
 
-    // draw lower line
-    RenderThickLine(renderer, 
+    // lower line
+    RasterizeStroke(spans, 
         {dimensions.x + offset, dimensions.y + dimensions.h - offset}, 
         {dimensions.x + dimensions.w - offset, dimensions.y + dimensions.h - offset}, 
         thickness
     );
 
+    return RenderSpans(renderer, spans);
 }
 
-// resizes a surface 
-SDL_Surface* ResizeSurface(SDL_Surface* original_surface, int window_width, int window_height) {
-    // make sure the new surface has the same format so information can be copied correctly
-    SDL_Surface* resized_surface = SDL_CreateRGBSurface(0, window_width, window_height,
-        original_surface->format->BitsPerPixel,
-        original_surface->format->Rmask,
-        original_surface->format->Gmask,
-        original_surface->format->Bmask,
-        original_surface->format->Amask
-    );
-    if (resized_surface == nullptr) {
-        std::cerr << "Could not create resized surface: " << SDL_GetError() << std::endl;
-        return nullptr;
-    }
+void AddThickLineQuad(std::vector<SDL_Vertex>& vertices, SDL_Point start, SDL_Point stop, int thickness,
+    SDL_Color color) {
 
-    // create a rectangle for the destination area
-    SDL_Rect dstRect = {0, 0, window_width, window_height};
+    // same quad as RenderThickLine, moved by half a pixel since geometry covers a pixel by its center
+    SDL_FPoint corners[4];
+    StrokeCorners(corners, start, stop, thickness);
+    for (SDL_FPoint& corner : corners) {
+        corner.x += 0.5f;
+        corner.y += 0.5f;
+    }
 
-    // copy the original surface to the resized surface, scaling it to fit
-    if (SDL_BlitScaled(original_surface, nullptr, resized_surface, &dstRect) != 0) {
-        std::cerr << "Could not scale surface: " << SDL_GetError() << std::endl;
-        SDL_FreeSurface(resized_surface);
-        return nullptr;
+    int triangles[6] = {0, 1, 2, 0, 2, 3};
+    for (int corner : triangles) {
+        vertices.push_back({corners[corner], color, {0, 0}});
     }
+}
 
-    return resized_surface;
+void AddTexturedQuad(std::vector<SDL_Vertex>& vertices, SDL_Rect dimensions) {
+    SDL_Color white = {255, 255, 255, 255}; // texture colors are not modulated
+    float left = dimensions.x;
+    float top = dimensions.y;
+    float right = dimensions.x + dimensions.w;
+    float bottom = dimensions.y + dimensions.h;
+
+    SDL_Vertex corners[4] = {
+        {{left, top}, white, {0, 0}},
+        {{right, top}, white, {1, 0}},
+        {{right, bottom}, white, {1, 1}},
+        {{left, bottom}, white, {0, 1}}
+    };
+    int triangles[6] = {0, 1, 2, 0, 2, 3};
+    for (int corner : triangles) {
+        vertices.push_back(corners[corner]);
+    }
 }
 
-// function to creeate a new texture of desired size from surface (original surface is destroyed)
-SDL_Texture* CreateSizedTexture(SDL_Renderer *renderer, SDL_Surface* original_surface, int window_width, int window_height) {
-    original_surface = ResizeSurface(original_surface, window_width, window_height);
-    if (original_surface == nullptr) {
-        std::cerr <<  "Failed to create texture from surface" << std::endl;
+// decodes an image file into a texture of the same size (it is scaled when it is copied)
+SDL_Texture* CreateTextureFromBMP(SDL_Renderer *renderer, const char *image_file_name) {
+    SDL_Surface* surface = SDL_LoadBMP(image_file_name);
+    if (surface == nullptr) {
+        LOG_ERROR("Could not load image: " << SDL_GetError() << "\n");
         return nullptr;
     }
 
-    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, original_surface);
+    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
+    SDL_FreeSurface(surface); // pixels are already uploaded
     if (texture == nullptr) {
-        std::cerr <<  "Failed to create texture from surface: " << SDL_GetError() << std::endl;
+        LOG_ERROR("Failed to create texture from surface: " << SDL_GetError() << "\n");
         return nullptr;
     }
 
-    SDL_FreeSurface(original_surface); // free the original surface
-
+    SDL_SetTextureScaleMode(texture, SDL_ScaleModeLinear); // smooth when stretched over the window
     return texture;
 }
-
-SDL_Texture* CreateSizedTextureFromBMP(SDL_Renderer *renderer, const char *image_file_name, int window_width, int window_height) {
-    SDL_Surface* aux_surface = SDL_LoadBMP(image_file_name);
-    if (aux_surface == nullptr) {
-        std::cerr << "Could not load image: " << SDL_GetError() << std::endl; 
-        return nullptr;
-    }
-
-    // prepare texture
-    SDL_Texture* texture = CreateSizedTexture(renderer, aux_surface, window_width, window_height);
-
-    return texture;
-}
\ No newline at end of file